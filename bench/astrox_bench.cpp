@@ -0,0 +1,373 @@
+//---------
+// Includes
+//---------
+
+// === Standart Library ===
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// === Other Libraries ===
+#include "raylib.h"
+#include "custom_button.hpp"
+#include "simulation.hpp"
+#include "audio_mixer.hpp"
+
+//-------------------
+// Constant Variables
+//-------------------
+
+#define BENCH_RUNS 9				// runs per benchmark (interleaved), the fastest is reported
+#define BENCH_BATCH 8				// calls per timed region for bodies that are cheaper than the clock
+#define BENCH_MIN_TIME 0.05			// minimum timed seconds per run
+#define BENCH_CONFIRM_ROUNDS 2		// extra rounds of runs for benchmarks that look regressed
+#define BENCH_DEFAULT_THRESHOLD 10.0	// allowed regression in percent
+#define BENCH_DELTA (1.0f / 120.0f)	// simulated frame time
+
+using namespace std::chrono;
+
+//------
+// Types
+//------
+struct BenchResult {
+	std::string name;
+	double nsPerOp;
+};
+
+// A result compared with its baseline entry
+struct BenchChange {
+	int index;			// into results
+	double change;		// percent, positive is slower
+	bool regressed;		// slower by more than the threshold
+};
+
+struct Benchmark {
+	std::string name;
+	std::function<void()> setup;	// runs before every body() call, not timed
+	std::function<int()> body;		// returns how many operations it performed
+	std::vector<double> samples;	// ns/op of each run
+};
+
+//--------
+// Globals
+//--------
+static std::vector<Benchmark> benchmarks;
+static std::vector<BenchResult> results;
+static std::mt19937 benchRandom(1234);	// fixed seed so every run sees the same scene
+static volatile int benchSink = 0;		// keeps results alive so loops are not optimized away
+static AudioMixer benchMixer;			// driven by hand, no audio device
+static float mixBuffer[AUDIO_BUFFER_FRAMES];
+
+//-----------
+// Functions
+//-----------
+
+// Register a benchmark; the lambdas must not capture locals by reference
+static void AddBenchmark(const std::string &name, std::function<void()> setup, std::function<int()> body) {
+	benchmarks.push_back(Benchmark{ name, setup, body, {} });
+}
+
+// Time one run of a benchmark: body() until BENCH_MIN_TIME has been spent in it
+static double TimeRun(Benchmark &benchmark) {
+	double timed = 0.0;
+	long long ops = 0;
+
+	while (timed < BENCH_MIN_TIME) {
+		benchmark.setup();
+		steady_clock::time_point start = steady_clock::now();
+		ops += benchmark.body();
+		timed += duration<double>(steady_clock::now() - start).count();
+	}
+
+	return timed * 1e9 / ops;
+}
+
+// Add BENCH_RUNS runs to each selected benchmark. Runs are interleaved, so a slow
+// phase of the machine costs every benchmark one run instead of all runs of one.
+static void RunBenchmarks(const std::vector<int> &selected) {
+	for (int run = 0; run < BENCH_RUNS; run++) {
+		for (int i = 0; i < selected.size(); i++) {
+			Benchmark &benchmark = benchmarks[selected[i]];
+			benchmark.samples.push_back(TimeRun(benchmark));
+		}
+	}
+}
+
+// Noise only ever adds time, so the fastest run is the most repeatable number
+static void CollectResults() {
+	results.clear();
+	for (int i = 0; i < benchmarks.size(); i++) {
+		double fastest = *std::min_element(benchmarks[i].samples.begin(), benchmarks[i].samples.end());
+		results.push_back(BenchResult{ benchmarks[i].name, fastest });
+	}
+}
+
+static float RandomCoordinate(float range) {
+	return std::uniform_real_distribution<float>(0.0f, range)(benchRandom);
+}
+
+static std::vector<Asteroid> MakeAsteroids(int count) {
+	std::vector<Asteroid> scene;
+	for (int i = 0; i < count; i++) {
+		Asteroid asteroid = { 0 };
+		asteroid.texture = asteroidTexture1;
+		asteroid.position = Vector2{ RandomCoordinate(worldWidth), RandomCoordinate(worldHeight) };
+		asteroid.speed = Vector2{ RandomCoordinate(ASTEROID_MAX_SPEED), RandomCoordinate(ASTEROID_MAX_SPEED) };
+		asteroid.rotation = RandomCoordinate(360.0f);
+		asteroid.status = i % 3;
+		asteroid.radius = 20.0f + 20.0f * asteroid.status;
+		scene.push_back(asteroid);
+	}
+	return scene;
+}
+
+static std::vector<Bullet> MakeBullets(int count) {
+	std::vector<Bullet> scene;
+	for (int i = 0; i < count; i++) {
+		Bullet bullet = { 0 };
+		bullet.position = Vector2{ RandomCoordinate(worldWidth), RandomCoordinate(worldHeight) };
+		bullet.speed = Vector2{ RandomCoordinate(BULLET_SPEED), RandomCoordinate(BULLET_SPEED) };
+		bullet.rotation = RandomCoordinate(360.0f);
+		bullet.radius = 5.0f;
+		scene.push_back(bullet);
+	}
+	return scene;
+}
+
+static void AddBenchmarks() {
+	// Fake textures: only their size is used by the simulation
+	asteroidTexture1 = Texture2D{ 0, 300, 300, 1, 0 };
+	asteroidTexture2 = Texture2D{ 0, 280, 280, 1, 0 };
+	asteroidTexture3 = Texture2D{ 0, 320, 320, 1, 0 };
+	player.position = Vector2{ worldWidth / 2.0f, worldHeight / 2.0f };
+	playerHitRadius = 25.0f;
+
+	// Random helpers
+	AddBenchmark("random_int", [] {}, [] {
+		for (int i = 0; i < 100; i++) random_int(0, 360);
+		return 100;
+	});
+	AddBenchmark("random_dbl", [] {}, [] {
+		for (int i = 0; i < 100; i++) random_dbl(ASTEROID_MIN_SPEED, ASTEROID_MAX_SPEED);
+		return 100;
+	});
+	AddBenchmark("random_flt", [] {}, [] {
+		for (int i = 0; i < 100; i++) random_flt(ASTEROID_MIN_SPEED, ASTEROID_MAX_SPEED);
+		return 100;
+	});
+
+	// Collision checks
+	std::vector<Bullet> collisionBullets = MakeBullets(64);
+	std::vector<Asteroid> collisionAsteroids = MakeAsteroids(64);
+	AddBenchmark("collision_circles/64x64", [] {}, [collisionBullets, collisionAsteroids] {
+		int hits = 0;
+		for (int i = 0; i < collisionAsteroids.size(); i++) {
+			for (int j = 0; j < collisionBullets.size(); j++) {
+				if (CheckCollisionCircles(collisionAsteroids[i].position, collisionAsteroids[i].radius, collisionBullets[j].position, collisionBullets[j].radius)) hits++;
+			}
+		}
+		benchSink = hits;
+		return (int)(collisionAsteroids.size() * collisionBullets.size());
+	});
+
+	// Spawning
+	AddBenchmark("spawn_asteroid", [] { asteroids.clear(); }, [] {
+		for (int i = 0; i < 100; i++) SpawnAsteroid(i % 3, Vector2{ 100.0f, 100.0f });
+		return 100;
+	});
+
+	// Update loops
+	int counts[] = { 16, 256, 4096 };
+	for (int c = 0; c < 3; c++) {
+		int count = counts[c];
+
+		std::vector<Bullet> bulletScene = MakeBullets(count);
+		// A few ticks barely move the bullets, so every call in the batch does the same work
+		AddBenchmark("update_bullets/" + std::to_string(count),
+			[bulletScene] { bullets = bulletScene; },
+			[] {
+				for (int i = 0; i < BENCH_BATCH; i++) UpdateBullets(bullets, BENCH_DELTA);
+				return BENCH_BATCH;
+			});
+
+		std::vector<Asteroid> asteroidScene = MakeAsteroids(count);
+		std::vector<Bullet> shotScene = MakeBullets(count / 8);
+		AddBenchmark("update_asteroids/" + std::to_string(count),
+			[asteroidScene, shotScene] { asteroids = asteroidScene; bullets = shotScene; waveDirector.reset(); },
+			[] { UpdateAsteroids(asteroids, BENCH_DELTA); return 1; });
+	}
+
+	// Audio mixer
+	benchMixer.loadSounds();
+	benchMixer.enabled = true;
+
+	// Lift the explosion limit on the bench mixer so one sound can fill the whole pool
+	benchMixer.sounds[SOUND_EXPLOSION].maxVoices = AUDIO_VOICES;
+	AddBenchmark("audio_play", [] { benchMixer.mix(mixBuffer, 0); }, [] {
+		for (int i = 0; i < 100; i++) benchMixer.play(SOUND_SHOT);
+		return 100;
+	});
+	AddBenchmark("audio_mix/" + std::to_string(AUDIO_VOICES) + "x" + std::to_string(AUDIO_BUFFER_FRAMES),
+		[] {
+			// Every voice busy, restarted so none ends inside the timed buffer
+			for (int i = 0; i < AUDIO_VOICES; i++) benchMixer.play(SOUND_EXPLOSION);
+			benchMixer.mix(mixBuffer, 0);
+		},
+		[] {
+			benchMixer.mix(mixBuffer, AUDIO_BUFFER_FRAMES);
+			benchSink = benchMixer.getActiveVoices();
+			return AUDIO_BUFFER_FRAMES;
+		});
+
+	// Button hit-testing. There is no window, so the mouse stays at the origin and the
+	// button (120 x 60 at this scale) is placed around it to take each path.
+	struct { const char* path; Vector2 position; } placements[] = {
+		{ "hit", Vector2{ -50.0f, -50.0f } },		// all four comparisons pass
+		{ "miss_x", Vector2{ 100.0f, 100.0f } },	// fails the first comparison
+		{ "miss_y", Vector2{ -50.0f, -100.0f } },	// passes x, fails the last comparison
+	};
+	for (int p = 0; p < 3; p++) {
+		CustomButton button(placements[p].position, 0.3f, Texture2D{ 0, 400, 200, 1, 0 }, "", 20, BLACK);
+		AddBenchmark(std::string("custom_button_is_hovered/") + placements[p].path, [] {}, [button]() mutable {
+			int hovered = 0;
+			for (int i = 0; i < 1000; i++) if (button.isHovered()) hovered++;
+			benchSink = hovered;
+			return 1000;
+		});
+	}
+}
+
+static bool WriteResults(const char* path) {
+	FILE* file = fopen(path, "w");
+	if (file == nullptr) return false;
+
+	fputs("{\n  \"benchmarks\": [\n", file);
+	for (int i = 0; i < results.size(); i++) {
+		fprintf(file, "    {\"name\": \"%s\", \"ns_per_op\": %.3f}%s\n", results[i].name.c_str(), results[i].nsPerOp, i + 1 < results.size() ? "," : "");
+	}
+	fputs("  ]\n}\n", file);
+
+	fclose(file);
+	return true;
+}
+
+// Read a file written by WriteResults (one benchmark per line)
+static bool ReadResults(const char* path, std::vector<BenchResult> &baseline) {
+	FILE* file = fopen(path, "r");
+	if (file == nullptr) return false;
+
+	char line[512];
+	char name[256];
+	double nsPerOp;
+	while (fgets(line, sizeof(line), file) != nullptr) {
+		if (sscanf(line, " {\"name\": \"%255[^\"]\", \"ns_per_op\": %lf}", name, &nsPerOp) == 2) {
+			baseline.push_back(BenchResult{ name, nsPerOp });
+		}
+	}
+
+	fclose(file);
+	return true;
+}
+
+// Compare every result that has a baseline entry; both the re-run decision and the
+// report use this list
+static std::vector<BenchChange> CompareResults(std::vector<BenchResult> &baseline, double threshold) {
+	std::vector<BenchChange> changes;
+
+	for (int i = 0; i < results.size(); i++) {
+		for (int j = 0; j < baseline.size(); j++) {
+			if (results[i].name != baseline[j].name) continue;
+
+			double change = (results[i].nsPerOp - baseline[j].nsPerOp) / baseline[j].nsPerOp * 100.0;
+			changes.push_back(BenchChange{ i, change, change > threshold });
+		}
+	}
+
+	return changes;
+}
+
+// Print the comparison, returns the number of regressions
+static int ReportChanges(std::vector<BenchChange> &changes) {
+	int regressions = 0;
+
+	for (int i = 0; i < changes.size(); i++) {
+		if (changes[i].regressed) regressions++;
+		printf("%-32s %+8.1f%%%s\n", results[changes[i].index].name.c_str(), changes[i].change, changes[i].regressed ? "  REGRESSION" : "");
+	}
+
+	return regressions;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* jsonPath = nullptr;
+	const char* baselinePath = nullptr;
+	double threshold = BENCH_DEFAULT_THRESHOLD;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonPath = argv[++i];
+		else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baselinePath = argv[++i];
+		else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) threshold = atof(argv[++i]);
+		else {
+			printf("Usage: astrox_bench [--json <out.json>] [--baseline <baseline.json>] [--threshold <percent>]\n");
+			printf("Exit codes: 0 ok, 1 regression, 2 usage or output error, 3 baseline missing\n");
+			return 2;
+		}
+	}
+
+	AddBenchmarks();
+
+	std::vector<int> all;
+	for (int i = 0; i < benchmarks.size(); i++) all.push_back(i);
+	RunBenchmarks(all);
+	CollectResults();
+
+	std::vector<BenchResult> baseline;
+	bool haveBaseline = baselinePath != nullptr && ReadResults(baselinePath, baseline);
+
+	// A slowdown has to survive more runs before it counts, one noisy round is not enough
+	for (int round = 0; haveBaseline && round < BENCH_CONFIRM_ROUNDS; round++) {
+		std::vector<BenchChange> changes = CompareResults(baseline, threshold);
+		std::vector<int> suspects;
+		for (int i = 0; i < changes.size(); i++) {
+			if (changes[i].regressed) suspects.push_back(changes[i].index);
+		}
+		if (suspects.empty()) break;
+
+		printf("Re-running %d benchmark(s) that look slower than the baseline\n", (int)suspects.size());
+		RunBenchmarks(suspects);
+		CollectResults();
+	}
+
+	for (int i = 0; i < results.size(); i++) {
+		printf("%-32s %12.1f ns/op\n", results[i].name.c_str(), results[i].nsPerOp);
+	}
+
+	if (jsonPath != nullptr && !WriteResults(jsonPath)) {
+		printf("Could not write %s\n", jsonPath);
+		return 2;
+	}
+
+	if (baselinePath != nullptr) {
+		if (!haveBaseline) {
+			printf("No baseline at %s, nothing to compare (create one with --json %s)\n", baselinePath, baselinePath);
+			return 3;
+		}
+
+		printf("\nCompared to %s (threshold %.1f%%):\n", baselinePath, threshold);
+		std::vector<BenchChange> changes = CompareResults(baseline, threshold);
+		int regressions = ReportChanges(changes);
+		if (regressions > 0) {
+			printf("%d benchmark(s) regressed\n", regressions);
+			return 1;
+		}
+	}
+
+	return 0;
+}
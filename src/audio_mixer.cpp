@@ -0,0 +1,241 @@
+#include "audio_mixer.hpp"
+#include "raylib.h"
+
+#include <math.h>
+#include <string.h>
+#include "trace.hpp"
+
+AudioMixer audioMixer;
+
+static AudioStream audioStream = { 0 };
+static bool audioDeviceOpen = false;
+
+//----------
+// Synthesis
+//----------
+
+// The repo ships no sound files, so the effects are generated once at startup
+
+static float Noise(uint32_t &seed) {
+	seed = seed * 1664525u + 1013904223u;
+	return (seed >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+// Falling square wave
+static std::vector<float> SynthesizeShot() {
+	int count = (int)(AUDIO_SAMPLE_RATE * 0.15f);
+	std::vector<float> samples(count);
+	float phase = 0.0f;
+
+	for (int i = 0; i < count; i++) {
+		float t = (float)i / AUDIO_SAMPLE_RATE;
+		phase += 1400.0f * powf(0.25f, t / 0.15f) / AUDIO_SAMPLE_RATE;
+		phase -= floorf(phase);
+		samples[i] = (phase < 0.5f ? 0.4f : -0.4f) * expf(-t * 20.0f);
+	}
+	return samples;
+}
+
+// Noise that gets darker as it decays
+static std::vector<float> SynthesizeExplosion() {
+	int count = (int)(AUDIO_SAMPLE_RATE * 0.6f);
+	std::vector<float> samples(count);
+	uint32_t seed = 1;
+	float filtered = 0.0f;
+
+	for (int i = 0; i < count; i++) {
+		float t = (float)i / AUDIO_SAMPLE_RATE;
+		filtered += (Noise(seed) - filtered) * (0.02f + 0.3f * expf(-t * 8.0f));
+		samples[i] = filtered * 2.0f * expf(-t * 6.0f);
+	}
+	return samples;
+}
+
+// Low rumble, the end is crossfaded into the start so it loops without a click
+static std::vector<float> SynthesizeThrust() {
+	int count = (int)(AUDIO_SAMPLE_RATE * 0.5f);
+	int crossfade = count / 10;
+	std::vector<float> noise(count + crossfade);
+	uint32_t seed = 7;
+	float filtered = 0.0f;
+
+	for (int i = 0; i < noise.size(); i++) {
+		filtered += (Noise(seed) - filtered) * 0.05f;
+		noise[i] = filtered * 3.0f;
+	}
+
+	std::vector<float> samples(noise.begin(), noise.begin() + count);
+	for (int i = 0; i < crossfade; i++) {
+		float blend = (float)i / crossfade;
+		samples[i] = noise[i] * blend + noise[count + i] * (1.0f - blend);
+	}
+	return samples;
+}
+
+//------
+// Mixer
+//------
+
+void AudioMixer::loadSounds() {
+	TRACE_FUNCTION();
+
+	sounds[SOUND_SHOT] = SoundData{ SynthesizeShot(), 4, 0.6f, false };
+	sounds[SOUND_EXPLOSION] = SoundData{ SynthesizeExplosion(), 4, 1.0f, false };
+	sounds[SOUND_THRUST] = SoundData{ SynthesizeThrust(), 1, 0.5f, true };
+}
+
+bool AudioMixer::play(SoundEffect sound, float gain) {
+	if (!enabled) return false;
+	return push(AudioCommand{ AUDIO_PLAY, sound, gain });
+}
+
+bool AudioMixer::stop(SoundEffect sound) {
+	if (!enabled) return false;
+	return push(AudioCommand{ AUDIO_STOP, sound, 0.0f });
+}
+
+// Called by a single producer (the simulation) at a time
+bool AudioMixer::push(AudioCommand command) {
+	uint32_t head = this->head.load(std::memory_order_relaxed);
+
+	// Full: drop the sound rather than wait for the audio thread
+	if (head - tail.load(std::memory_order_acquire) >= AUDIO_COMMAND_SIZE) return false;
+
+	commands[head & (AUDIO_COMMAND_SIZE - 1)] = command;
+	this->head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+// Take a free voice, or steal the oldest one. A sound at its voice limit
+// replaces its own oldest voice instead.
+void AudioMixer::start(int sound, float gain) {
+	if (sounds[sound].samples.empty()) return;
+
+	int playing = 0;
+	int oldestSame = -1;
+	int oldest = -1;
+	int free = -1;
+
+	for (int i = 0; i < AUDIO_VOICES; i++) {
+		if (!voices[i].active) {
+			if (free == -1) free = i;
+			continue;
+		}
+
+		if (oldest == -1 || voices[i].order < voices[oldest].order) oldest = i;
+
+		if (voices[i].sound == sound) {
+			playing++;
+			if (oldestSame == -1 || voices[i].order < voices[oldestSame].order) oldestSame = i;
+		}
+	}
+
+	int slot = playing >= sounds[sound].maxVoices ? oldestSame : (free != -1 ? free : oldest);
+	voices[slot] = Voice{ sound, 0, gain * sounds[sound].volume, 0.0f, nextOrder++, true };
+}
+
+void AudioMixer::mix(float* out, unsigned int frames) {
+	// No tracing here: this runs on the audio device thread
+
+	uint32_t head = this->head.load(std::memory_order_acquire);
+	uint32_t tail = this->tail.load(std::memory_order_relaxed);
+	for (; tail != head; tail++) {
+		AudioCommand &command = commands[tail & (AUDIO_COMMAND_SIZE - 1)];
+
+		if (command.type == AUDIO_PLAY) start(command.sound, command.gain);
+		else if (command.type == AUDIO_STOP) {
+			for (int i = 0; i < AUDIO_VOICES; i++) {
+				if (voices[i].active && voices[i].sound == command.sound && voices[i].fade == 0.0f) {
+					voices[i].fade = voices[i].gain / AUDIO_RELEASE_FRAMES;
+				}
+			}
+		}
+	}
+	this->tail.store(tail, std::memory_order_release);
+
+	memset(out, 0, frames * sizeof(float));
+
+	int active = 0;
+	for (int v = 0; v < AUDIO_VOICES; v++) {
+		Voice &voice = voices[v];
+		if (!voice.active) continue;
+
+		const SoundData &sound = sounds[voice.sound];
+		int count = sound.samples.size();
+
+		for (unsigned int i = 0; i < frames; i++) {
+			if (voice.cursor >= count) {
+				if (!sound.loop) {
+					voice.active = false;
+					break;
+				}
+				voice.cursor = 0;
+			}
+
+			if (voice.fade > 0.0f) {
+				voice.gain -= voice.fade;
+				if (voice.gain <= 0.0f) {
+					voice.active = false;
+					break;
+				}
+			}
+
+			out[i] += sound.samples[voice.cursor++] * voice.gain;
+		}
+
+		if (voice.active) active++;
+	}
+
+	for (unsigned int i = 0; i < frames; i++) {
+		out[i] = fminf(fmaxf(out[i] * AUDIO_MASTER_VOLUME, -1.0f), 1.0f);
+	}
+
+	activeVoices.store(active, std::memory_order_relaxed);
+}
+
+int AudioMixer::getActiveVoices() {
+	return activeVoices.load(std::memory_order_relaxed);
+}
+
+//-------
+// Device
+//-------
+
+// raylib callbacks carry no user pointer, so the stream always feeds the global mixer
+static void MixAudioStream(void* buffer, unsigned int frames) {
+	audioMixer.mix((float*)buffer, frames);
+}
+
+bool InitAudio(bool useDevice) {
+	TRACE_FUNCTION();
+
+	audioMixer.loadSounds();
+	if (!useDevice) return false;
+
+	InitAudioDevice();
+	if (!IsAudioDeviceReady()) {
+		TraceLog(LOG_WARNING, "AUDIO: No audio device, running without sound");
+		return false;
+	}
+	audioDeviceOpen = true;
+
+	SetAudioStreamBufferSizeDefault(AUDIO_BUFFER_FRAMES);
+	audioStream = LoadAudioStream(AUDIO_SAMPLE_RATE, 32, 1);
+	SetAudioStreamCallback(audioStream, MixAudioStream);
+
+	audioMixer.enabled = true;
+	PlayAudioStream(audioStream);
+	return true;
+}
+
+void ShutdownAudio() {
+	TRACE_FUNCTION();
+
+	audioMixer.enabled = false;
+	if (!audioDeviceOpen) return;
+
+	StopAudioStream(audioStream);
+	UnloadAudioStream(audioStream);
+	CloseAudioDevice();
+	audioDeviceOpen = false;
+}
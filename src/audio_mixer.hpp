@@ -0,0 +1,88 @@
+#ifndef AUDIO_MIXER_INCLUDED
+
+#define AUDIO_MIXER_INCLUDED
+#include <atomic>
+#include <vector>
+#include <stdint.h>
+
+// Sound effect mixer.
+//
+// All effects are created once at startup. The game queues play/stop commands
+// into a lock-free ring buffer and the audio thread applies them and mixes a
+// fixed pool of voices straight into a raylib AudioStream, so triggering a sound
+// never allocates, locks or touches the audio device. Without a device the mixer
+// stays disabled and triggers return immediately; mix() can still be driven by
+// hand (see astrox_bench).
+
+#define AUDIO_SAMPLE_RATE 44100
+#define AUDIO_BUFFER_FRAMES 1024		// frames per stream buffer (about 23 ms)
+#define AUDIO_VOICES 16					// sounds playing at the same time
+#define AUDIO_COMMAND_SIZE 256			// queued commands, must be a power of two
+#define AUDIO_RELEASE_FRAMES 512		// fade-out length of a stopped sound
+#define AUDIO_MASTER_VOLUME 0.5f
+
+enum SoundEffect {
+	SOUND_SHOT,
+	SOUND_EXPLOSION,
+	SOUND_THRUST,
+	SOUND_EFFECT_COUNT
+};
+
+struct SoundData {
+	std::vector<float> samples;		// mono, AUDIO_SAMPLE_RATE
+	int maxVoices;					// voices this sound may use at once
+	float volume;
+	bool loop;
+};
+
+struct Voice {
+	int sound;
+	int cursor;				// next sample to play
+	float gain;
+	float fade;				// gain removed per sample while stopping
+	uint32_t order;			// start order, the oldest voice is stolen first
+	bool active;
+};
+
+enum AudioCommandType {
+	AUDIO_PLAY,
+	AUDIO_STOP
+};
+
+struct AudioCommand {
+	int type;
+	int sound;
+	float gain;
+};
+
+class AudioMixer {
+	public:
+
+		SoundData sounds[SOUND_EFFECT_COUNT];
+		Voice voices[AUDIO_VOICES] = {};
+		bool enabled = false;						// set before the game starts triggering sounds
+
+		void loadSounds();									// Create every effect (call once, before mixing starts)
+		bool play(SoundEffect sound, float gain = 1.0f);	// Queue a sound, false if disabled or the queue is full
+		bool stop(SoundEffect sound);						// Fade out every voice playing a sound
+		void mix(float* out, unsigned int frames);			// Apply queued commands and render frames (audio thread)
+		int getActiveVoices();								// Voices playing after the last mix()
+
+	private:
+
+		AudioCommand commands[AUDIO_COMMAND_SIZE];
+		std::atomic<uint32_t> head{ 0 };		// next command to write, owned by the game
+		std::atomic<uint32_t> tail{ 0 };		// next command to apply, owned by the audio thread
+		std::atomic<int> activeVoices{ 0 };
+		uint32_t nextOrder = 0;
+
+		bool push(AudioCommand command);
+		void start(int sound, float gain);
+};
+
+extern AudioMixer audioMixer;
+
+bool InitAudio(bool useDevice);		// Load the effects and start the stream, false if running silent
+void ShutdownAudio();				// Stop the stream and close the device
+
+#endif
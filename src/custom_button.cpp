@@ -51,6 +51,10 @@ bool CustomButton::isClicked() {
 	return false;
 }
 
+bool CustomButton::isClicked(bool mousePressed) {
+	return mousePressed && isHovered();
+}
+
 void CustomButton::Draw() {
 	DrawTextureEx(texture, position, 0.0f, scale, WHITE);
 	DrawText(text, position.x + ((texture.width * scale) / 2) - MeasureText(text, fontSize) / 2, (position.y + texture.height * scale / 2) - fontSize / 2, fontSize, textColor);
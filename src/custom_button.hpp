@@ -31,6 +31,7 @@ class CustomButton {
 		// State getters
 		bool isHovered(); 	// check if the mouse is hovering over the button
 		bool isClicked(); 	// check if the button is clicked
+		bool isClicked(bool mousePressed);	// check if the button is clicked, given whether the mouse was pressed this frame
 
 
 		// Drawing the button
@@ -0,0 +1,159 @@
+#include "frame_governor.hpp"
+#include <math.h>
+
+// Governor tuning
+#define GOVERNOR_SMOOTHING 0.1f			// weight of the newest frame in the average
+#define GOVERNOR_DOWN_THRESHOLD 0.9f	// step down above 90% of the budget
+#define GOVERNOR_UP_THRESHOLD 0.5f		// step up below 50% of the budget
+#define GOVERNOR_LATE_THRESHOLD 1.2f	// frames 20% longer than the budget missed their slot
+#define GOVERNOR_DOWN_FRAMES 30			// frames over budget before stepping down
+#define GOVERNOR_UP_FRAMES 240			// frames with headroom before stepping up
+#define GOVERNOR_TRIAL_FRAMES 60		// frames a resolution step down gets to fix late frames
+#define GOVERNOR_MAX_BACKOFF 7200		// longest wait between two failed trials (1 minute at 120 FPS)
+
+// Resolution step on trial
+#define TRIAL_DOWN 1					// kept only if the frames are on time afterwards
+#define TRIAL_UP 2						// undone as soon as frames run late
+
+FrameGovernor::FrameGovernor(int targetFPS) {
+	this->pipelined = false;
+	setTargetFPS(targetFPS);
+}
+
+void FrameGovernor::setTargetFPS(int targetFPS) {
+	this->budget = 1.0f / (float)targetFPS;
+	this->frameInterval = this->budget;
+	this->averageWork = 0.0f;
+	this->averageFrame = 0.0f;
+	this->level = QUALITY_FULL;
+	this->overBudgetFrames = 0;
+	this->headroomFrames = 0;
+	this->gpuBound = false;
+	this->trial = 0;
+	this->trialFrames = 0;
+	this->upFrames = GOVERNOR_UP_FRAMES;
+	this->retryDelay = GOVERNOR_UP_FRAMES;
+	this->retryFrames = 0;
+}
+
+void FrameGovernor::setPipelined(bool pipelined) {
+	this->pipelined = pipelined;
+}
+
+// A display slower than the target FPS caps the frame rate; that is not GPU load
+void FrameGovernor::setDisplayRate(int refreshRate) {
+	this->frameInterval = refreshRate > 0 ? fmaxf(budget, 1.0f / (float)refreshRate) : budget;
+}
+
+void FrameGovernor::recordFrame(float updateTime, float drawTime, float frameTime) {
+	float work = pipelined ? fmaxf(updateTime, drawTime) : updateTime + drawTime;
+	averageWork += (work - averageWork) * GOVERNOR_SMOOTHING;
+	averageFrame += (frameTime - averageFrame) * GOVERNOR_SMOOTHING;
+
+	bool workOver = averageWork > budget * GOVERNOR_DOWN_THRESHOLD;
+	bool late = averageFrame > frameInterval * GOVERNOR_LATE_THRESHOLD;
+
+	if (retryFrames > 0) retryFrames--;
+
+	// Judge the resolution step on trial
+	if (trial == TRIAL_UP && late) {
+		// The higher resolution does not fit: go back and wait longer before the next try
+		level++;
+		trial = 0;
+		upFrames = upFrames * 2 < GOVERNOR_MAX_BACKOFF ? upFrames * 2 : GOVERNOR_MAX_BACKOFF;
+		overBudgetFrames = 0;
+		headroomFrames = 0;
+		return;
+	}
+	if (trial != 0 && --trialFrames <= 0) {
+		if (trial == TRIAL_DOWN && late) {
+			// Lower resolution did not help (CPU side swap, display cap, ...): undo it
+			level--;
+			retryFrames = retryDelay;
+			retryDelay = retryDelay * 2 < GOVERNOR_MAX_BACKOFF ? retryDelay * 2 : GOVERNOR_MAX_BACKOFF;
+		}
+		else if (trial == TRIAL_UP) {
+			upFrames = GOVERNOR_UP_FRAMES;
+		}
+		trial = 0;
+		overBudgetFrames = 0;
+		headroomFrames = 0;
+	}
+	if (trial == TRIAL_DOWN) return;
+
+	if (workOver || late) {
+		overBudgetFrames++;
+		headroomFrames = 0;
+		gpuBound = !workOver;
+	}
+	else if (averageWork < budget * GOVERNOR_UP_THRESHOLD) {
+		headroomFrames++;
+		overBudgetFrames = 0;
+	}
+	else {
+		overBudgetFrames = 0;
+		headroomFrames = 0;
+	}
+
+	// The resolution steps only save GPU time, so CPU bound frames stop before them
+	int lowestLevel = gpuBound && retryFrames == 0 ? QUALITY_LEVEL_COUNT - 1 : QUALITY_LOW_HUD;
+
+	// Drop quickly when over budget, come back slowly to avoid oscillating
+	if (overBudgetFrames >= GOVERNOR_DOWN_FRAMES && level < lowestLevel) {
+		stepDown();
+	}
+	else if (headroomFrames >= (level >= QUALITY_LOW_RESOLUTION ? upFrames : GOVERNOR_UP_FRAMES) && level > QUALITY_FULL) {
+		stepUp();
+	}
+}
+
+void FrameGovernor::stepDown() {
+	level++;
+	overBudgetFrames = 0;
+
+	if (level >= QUALITY_LOW_RESOLUTION) {
+		trial = TRIAL_DOWN;
+		trialFrames = GOVERNOR_TRIAL_FRAMES;
+	}
+}
+
+// CPU headroom says nothing about the GPU, so leaving a resolution level is a trial
+void FrameGovernor::stepUp() {
+	if (level >= QUALITY_LOW_RESOLUTION) {
+		trial = TRIAL_UP;
+		trialFrames = GOVERNOR_TRIAL_FRAMES;
+	}
+
+	level--;
+	headroomFrames = 0;
+}
+
+int FrameGovernor::getLevel() {
+	return level;
+}
+
+const char* FrameGovernor::getLevelName() {
+	switch (level) {
+		case QUALITY_FULL: return "Full";
+		case QUALITY_NO_DEBUG_SHAPES: return "No debug shapes";
+		case QUALITY_LOW_HUD: return "Low HUD rate";
+		case QUALITY_LOW_RESOLUTION: return "75% resolution";
+		case QUALITY_LOWEST_RESOLUTION: return "50% resolution";
+	}
+	return "";
+}
+
+bool FrameGovernor::drawDebugShapes() {
+	return level < QUALITY_NO_DEBUG_SHAPES;
+}
+
+float FrameGovernor::hudRefreshInterval() {
+	if (level >= QUALITY_LOW_HUD) return 0.25f;
+	return 0.0f;
+}
+
+float FrameGovernor::renderScale() {
+	if (level >= QUALITY_LOWEST_RESOLUTION) return 0.5f;
+	if (level >= QUALITY_LOW_RESOLUTION) return 0.75f;
+	return 1.0f;
+}
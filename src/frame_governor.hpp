@@ -0,0 +1,65 @@
+#ifndef FRAME_GOVERNOR_INCLUDED
+
+#define FRAME_GOVERNOR_INCLUDED
+
+// Quality levels, each one drops a bit more optional work than the previous
+enum QualityLevel {
+	QUALITY_FULL = 0,			// everything is drawn
+	QUALITY_NO_DEBUG_SHAPES,	// debug collision circles are skipped
+	QUALITY_LOW_HUD,			// HUD text is refreshed at a lower rate
+	QUALITY_LOW_RESOLUTION,		// world is rendered at 75% resolution
+	QUALITY_LOWEST_RESOLUTION,	// world is rendered at 50% resolution
+	QUALITY_LEVEL_COUNT
+};
+
+class FrameGovernor {
+	public:
+
+		// Frame budget
+		float budget;			// target frame time in seconds (1 / target FPS)
+		float averageWork;		// smoothed frame cost in seconds
+		float averageFrame;		// smoothed wall-clock frame time in seconds
+		float frameInterval;	// shortest frame the display allows, budget if unknown
+		bool pipelined;			// update and draw run on different threads
+
+		// Constructors
+		FrameGovernor() = default;
+		FrameGovernor(int targetFPS);
+
+		// Setters
+		void setTargetFPS(int targetFPS);
+		void setPipelined(bool pipelined);
+		void setDisplayRate(int refreshRate);	// display refresh rate in Hz (0 = unknown)
+
+		// Feed the measured update and draw time of the last frame and its
+		// wall-clock time (seconds). The CPU cost is their sum, or the larger of
+		// the two when pipelined. Frames that run late although the CPU cost fits
+		// the budget are GPU or present bound. The frame limiter hides spare GPU
+		// time, so resolution steps are trials: one that does not fix late frames
+		// is undone, and a failed step back up waits twice as long next time.
+		void recordFrame(float updateTime, float drawTime, float frameTime);
+
+		// State getters
+		int getLevel();					// current quality level (QualityLevel)
+		const char* getLevelName();		// printable name of the current level
+		bool drawDebugShapes();			// should debug circles be drawn
+		float hudRefreshInterval();		// seconds between HUD text refreshes
+		float renderScale();			// world render resolution scale (0..1]
+
+	private:
+
+		int level = QUALITY_FULL;
+		int overBudgetFrames = 0;		// consecutive frames over budget
+		int headroomFrames = 0;			// consecutive frames with enough headroom
+		bool gpuBound = false;			// last time over budget, it was not the CPU work
+		int trial = 0;					// resolution step on trial (TRIAL_*), 0 = none
+		int trialFrames = 0;			// frames left before a step down is judged
+		int upFrames = 0;				// headroom frames needed before stepping up
+		int retryDelay = 0;				// frames resolution steps stay off after a failed one
+		int retryFrames = 0;			// frames until resolution steps are allowed again
+
+		void stepDown();
+		void stepUp();
+};
+
+#endif
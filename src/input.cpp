@@ -0,0 +1,58 @@
+#include "input.hpp"
+#include "raylib.h"
+
+#define LATENCY_REPORT_INTERVAL 2.0 // 2 seconds
+
+// Presses picked up by LatchInput. Its poll moves them into the "previous" key
+// state, so IsKeyPressed would miss them next frame; they are handed over here.
+static InputSnapshot pendingPresses = { 0 };
+
+static void ReadHeldKeys(InputSnapshot &snapshot) {
+	snapshot.rotateLeft = IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A);
+	snapshot.rotateRight = IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D);
+	snapshot.thrust = IsKeyDown(KEY_UP) || IsKeyDown(KEY_W);
+	snapshot.brake = IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_S);
+	snapshot.shoot = IsKeyDown(KEY_SPACE);
+	snapshot.time = GetTime();
+}
+
+static void ReadPresses(InputSnapshot &snapshot) {
+	snapshot.pausePressed = snapshot.pausePressed || IsKeyPressed('P');
+	snapshot.restartPressed = snapshot.restartPressed || IsKeyPressed(KEY_ENTER);
+	snapshot.clickPressed = snapshot.clickPressed || IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+}
+
+InputSnapshot SampleInput() {
+	InputSnapshot snapshot = pendingPresses;
+	pendingPresses = InputSnapshot{ 0 };
+
+	ReadHeldKeys(snapshot);
+	ReadPresses(snapshot);
+	return snapshot;
+}
+
+InputSnapshot LatchInput() {
+	PollInputEvents();
+
+	InputSnapshot snapshot = { 0 };
+	ReadHeldKeys(snapshot);
+	ReadPresses(pendingPresses);
+	return snapshot;
+}
+
+void LatencyMeter::record(double latency, double now) {
+	total += latency;
+	samples++;
+	if (latency > windowMaximum) windowMaximum = latency;
+
+	if (now - lastReport >= LATENCY_REPORT_INTERVAL) {
+		average = total / samples;
+		maximum = windowMaximum;
+		TraceLog(LOG_INFO, "LATENCY: input to submit avg %.2f ms, max %.2f ms (%d frames)", average * 1000.0, maximum * 1000.0, samples);
+
+		total = 0.0;
+		windowMaximum = 0.0;
+		samples = 0;
+		lastReport = now;
+	}
+}
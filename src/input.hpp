@@ -0,0 +1,43 @@
+#ifndef INPUT_INCLUDED
+
+#define INPUT_INCLUDED
+
+// Everything the game reads from the keyboard and mouse in one frame
+struct InputSnapshot {
+	// Held keys
+	bool rotateLeft;	// A / Left arrow
+	bool rotateRight;	// D / Right arrow
+	bool thrust;		// W / Up arrow
+	bool brake;			// S / Down arrow
+	bool shoot;			// Space
+
+	// Presses since the last snapshot
+	bool pausePressed;		// P
+	bool restartPressed;	// Enter
+	bool clickPressed;		// left mouse button
+
+	double time;		// GetTime() when the snapshot was taken
+};
+
+InputSnapshot SampleInput();	// Read the input state polled at the end of the last frame
+InputSnapshot LatchInput();		// Poll the devices again and re-read the held keys (late latch)
+
+// Collects input-to-submit latency samples (input sample time to the frame's
+// draw calls being submitted, before the buffer swap) and logs them periodically
+class LatencyMeter {
+	public:
+
+		double average = 0.0;	// average latency of the last reported window (seconds)
+		double maximum = 0.0;	// worst latency of the last reported window (seconds)
+
+		void record(double latency, double now);	// add a sample, reports once per interval
+
+	private:
+
+		double total = 0.0;
+		double windowMaximum = 0.0;
+		int samples = 0;
+		double lastReport = 0.0;
+};
+
+#endif
@@ -10,66 +10,49 @@
 #include <string>
 #include <math.h>
 #include <iterator>
+#include <string.h>
 
 // === Other Libraries ===
 #include "raylib.h"
+#include "rlgl.h"
 #include "custom_button.hpp"
+#include "frame_governor.hpp"
+#include "spatial_grid.hpp"
+#include "trace.hpp"
+#include "simulation.hpp"
+#include "audio_mixer.hpp"
+#include "input.hpp"
 
 //-------------------
 // Constant Variables
 //-------------------
 
-// === Player ===
-#define PLAYER_SIZE  0.2f
-#define PLAYER_SPEED 300.0f
-#define PLAYER_ROTATION_SPEED 250.0f
-#define PLAYER_ACCELERATION 0.5f
-#define PLAYER_MAX_ACCELERATION 2.5f
-#define DRAG 0.02f
-
-// === Bullet ===
-#define BULLET_SPEED 400.0f
-#define BULLET_SIZE 0.4f
-#define SHOOTING_DELAY 0.1f // 0.1 seconds
-
-// === Asteroid ===
-#define ASTEROID_BIG_SIZE 0.5f
-#define ASTEROID_MEDIUM_SIZE 0.3f
-#define ASTEROID_SMALL_SIZE 0.1f
-#define ASTEROID_MAX_SPEED 200.0f
-#define ASTEROID_MIN_SPEED 150.0f
+// === Frame Governor ===
+#define TARGET_FPS 120
+
+// === World ===
+#define MINIMAP_WIDTH 200
 
 using namespace std::chrono;
 
 //------
 // Types
 //------
-struct Player {
-    Vector2 position;
-    Vector2 speed;
-    float acceleration;
-    float rotation;
-};
-
-struct Bullet {
+struct StartText {
 	Vector2 position;
-	Vector2 speed;
-	float rotation;
-	float radius;
-};
-
-struct Asteroid {
 	Texture2D texture;
-	Vector2 position;
-	Vector2 speed;
-	float rotation;
-	float radius;
-	int status; // 2 = big, 1 = medium, 0 = small
 };
 
-struct StartText {
-	Vector2 position;
-	Texture2D texture;
+struct HudText {
+	std::string score;
+	std::string wave;
+	std::string fps;
+	std::string acceleration;
+	std::string rotation;
+	std::string bulletCount;
+	std::string drawnCount;
+	std::string quality;
+	std::string latency;
 };
 
 //--------
@@ -81,20 +64,20 @@ static const int screenWidth = 1000;
 static const int screenHeight = 800;
 
 static bool startScreen = true;
-static bool gameOver = false;
 static bool pause = false;
 static bool victory = false;
 static bool debug = false;
 
-static int score = 0;
-static int lives = 3;
-
 // === Player ===
-static Player player = { 0 };
 static Texture2D playerTexture;
 static Texture2D playerTextureFlight;
-static bool playerFlying = false;
-static float shipHeight = 0.0f;
+
+// === Input ===
+static InputSnapshot input = { 0 };		// input used by the current update
+static bool lateLatch = false;			// re-sample input right before drawing the ship
+static bool measureLatency = false;		// log input-to-submit latency
+static LatencyMeter latencyMeter;
+static double shipInputTime = 0.0;		// sample time of the input the drawn ship reflects
 
 // === User Interface ===
 static CustomButton btnPause;
@@ -114,60 +97,108 @@ static Texture2D startButtonTextureHover;
 
 // === Bullets ===
 static Texture2D bulletTexture;
-static std::vector<Bullet> bullets;
 
-// === Asteroids ===
-static Texture2D asteroidTexture1;
-static Texture2D asteroidTexture2;
-static Texture2D asteroidTexture3;
-static std::vector<Asteroid> asteroids;
+// === Simulation ===
+static bool pipelined = true;			// run the simulation on its own thread
+static RenderSnapshot* frame = nullptr;	// world state being drawn (never the live simulation state)
+static unsigned int restartCount = 0;	// restarts requested from the simulation
+
+// === Audio ===
+static bool audio = true;				// open the audio device
 
-static double shotTime = -SHOOTING_DELAY;
+// === World ===
+static Vector2 cameraTarget = { 0 };	// world position at the center of the view
+static SpatialGrid bulletGrid;
+static SpatialGrid asteroidGrid;
+static std::vector<int> visibleIds;		// scratch list for view queries
+static int drawnEntities = 0;			// bullets and asteroids drawn last frame
+
+// === Frame Governor ===
+static FrameGovernor governor;
+static RenderTexture2D worldTarget;		// scaled world target used when the governor lowers resolution
+static double drawTime = 0.0;			// CPU time of the last DrawGame (without the frame wait)
+
+static HudText hudText;
+static double hudRefreshTime = -1.0;
 
 
 // === Function prototypes ===
-static void InitGame();         								// Initialize game
+static void LoadGame();         								// Load textures and user interface
+static void ResetGame();        								// Start a new game
+static void RestartGame();      								// Ask the simulation to start a new game
+static void ResetInterface();   								// Close menus and overlays for a new game
 static void UpdateGame();       								// Update game (one frame)
 static void DrawGame();        									// Draw game (one frame)
 static void UnloadGame();       								// Unload game
 static void UpdateDrawFrame();  								// Update and Draw (one frame)
 
-static void UpdatePlayer();     								// Update player
 static void DrawPlayer(); 										// Draw player
 
+static void UpdateWorldCamera();								// Follow the player with the camera
+static void UpdateSpatialIndex();								// Rebuild bullet and asteroid grids
+static Rectangle GetViewRect();									// World area covered by the view
+static void DrawWorld(float renderScale);						// Draw bullets, asteroids and player
+static void DrawMinimap();										// Draw minimap
+static void UpdateHudText();									// Refresh cached HUD text
 static void DrawDebugInfo();									// Draw debug info
 static void DisplayScore();										// Display score
 static void DrawPlayerLives();									// Draw player lives
 
-static void Shoot();											// Shoot
-static void UpdateBullets(std::vector<Bullet> &bullets);		// Update bullets
 static void DrawBullet(Bullet bullet);				    		// Draw bullet
-static void DrawBullets(std::vector<Bullet> bullets);			// Draw bullets
+static void DrawBullets(std::vector<Bullet> &bullets);			// Draw bullets
 
-static void SpawnAsteroid(int status, Vector2 position);		// Spawn asteroid
 static void DrawAsteroid(Asteroid asteroid);					// Draw asteroid
-static void DrawAsteroids(std::vector<Asteroid> asteroids);		// Draw asteroids
-static void UpdateAsteroids(std::vector<Asteroid> &asteroids);	// Update asteroids
-
-int random_int(int range_from, int range_to);					// Generate random int
-double random_dbl(double range_from, double range_to);			// Generate random double
-float random_flt(float range_from, float range_to);				// Generate random float
+static void DrawAsteroids(std::vector<Asteroid> &asteroids);	// Draw asteroids
 
 
-int main()
+int main(int argc, char* argv[])
 {
+	// Command line:
+	// --trace <file>  writes a Chrome trace of every frame
+	// --late-latch    re-samples input right before the ship is drawn
+	// --latency       logs input-to-submit latency
+	// --no-pipeline   runs the simulation on the main thread
+	// --no-audio      runs without opening the audio device
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+			const char* tracePath = argv[++i];
+			if (TraceStart(tracePath)) TraceSetThreadName("main");
+			else TraceLog(LOG_WARNING, "TRACE: Could not open %s", tracePath);
+		}
+		else if (strcmp(argv[i], "--late-latch") == 0) lateLatch = true;
+		else if (strcmp(argv[i], "--latency") == 0) measureLatency = true;
+		else if (strcmp(argv[i], "--no-pipeline") == 0) pipelined = false;
+		else if (strcmp(argv[i], "--no-audio") == 0) audio = false;
+	}
+
     InitWindow(screenWidth, screenHeight, "AstroX");
-    SetTargetFPS(120);
-    InitGame();
+    SetTargetFPS(TARGET_FPS);
+    governor = FrameGovernor(TARGET_FPS);
+    governor.setPipelined(pipelined);
+    governor.setDisplayRate(GetMonitorRefreshRate(GetCurrentMonitor()));
+
+    worldTarget = LoadRenderTexture(screenWidth, screenHeight);
+    SetTextureFilter(worldTarget.texture, TEXTURE_FILTER_BILINEAR);
+
+    InitAudio(audio);
+    LoadGame();
+    ResetGame();
+
+    if (pipelined) StartSimulationThread(TARGET_FPS);
 
     while (!WindowShouldClose())
     {
         UpdateDrawFrame();
     }
 
+    StopSimulationThread();
+    ShutdownAudio();
     UnloadGame();        
+    UnloadRenderTexture(worldTarget);
     CloseWindow(); 
 
+	TraceStop();
+
     return 0;
 }
 
@@ -175,27 +206,16 @@ int main()
 // Functions
 //-----------
 
-// Initialize game variables
-void InitGame()
+// Load textures and set up the user interface (once)
+void LoadGame()
 {
-    bool correctRange = false;
-    gameOver = false;
-	pause = false;
-	victory = false;
-	debug = false;
-
-	score = 0;
-	lives = 3;
-
+	TRACE_FUNCTION();
 
     // Initialization player
 	playerTextureFlight = LoadTexture("./assets/Flight.png");
 	playerTexture = LoadTexture("./assets/Spaceship.png");
-    player.position = Vector2 {screenWidth/2 - (float) playerTexture.width * PLAYER_SIZE, screenHeight / 2 - (float) playerTexture.height * PLAYER_SIZE};
-    player.speed = Vector2 {0, 0};
-    player.acceleration = 0;
-    player.rotation = 0;
 	shipHeight = (1.2 * PLAYER_SIZE) / tanf(20*DEG2RAD);
+	playerHitRadius = playerTexture.width * PLAYER_SIZE / 2.5;
 
 	// Initialization buttons
 	btnPauseTexture = LoadTexture("./assets/pause_btn.png");
@@ -223,21 +243,58 @@ void InitGame()
 
 	// Initialization bullets
 	bulletTexture = LoadTexture("./assets/bullet.png");
-	bullets.clear();
+	bulletRadius = bulletTexture.width * BULLET_SIZE / 2;
 
 	// Initialization asteroids
 	asteroidTexture1 = LoadTexture("./assets/asteroid_1.png");
 	asteroidTexture2 = LoadTexture("./assets/asteroid_2.png");
 	asteroidTexture3 = LoadTexture("./assets/asteroid_3.png");
-	asteroids.clear();
+	waveDirector.waves = LoadWaveTable("./assets/waves.txt");
+
+	// Initialization world
+	bulletGrid = SpatialGrid(worldWidth, worldHeight, WORLD_CELL_SIZE);
+	asteroidGrid = SpatialGrid(worldWidth, worldHeight, WORLD_CELL_SIZE);
+}
+
+// Initialize game variables (the simulation thread must not be running)
+void ResetGame()
+{
+	TRACE_FUNCTION();
+
+	ResetInterface();
+	ResetSimulation();
+
+	// Draw the fresh world right away instead of the last snapshot of the old one
+	PublishSnapshot(0.0f);
+	frame = &ConsumeSnapshot();
+	UpdateWorldCamera();
+}
+
+// Restart after game over or from the pause menu. The simulation keeps running and
+// resets itself on its next tick, so restarting never creates a thread.
+void RestartGame()
+{
+	ResetInterface();
+	restartCount++;
+}
+
+void ResetInterface()
+{
+	pause = false;
+	victory = false;
+	debug = false;
 }
 
 // Update game (one frame)
 void UpdateGame(void)
 {
+	TRACE_FUNCTION();
+
+	input = SampleInput();
+
 	if (startScreen) {
 
-		if (startButton.isClicked()) {
+		if (startButton.isClicked(input.clickPressed)) {
 			startScreen = false;
 		}
 
@@ -248,12 +305,9 @@ void UpdateGame(void)
 		}
 	}
 
-    if (!gameOver)
+    if (!frame->gameOver)
     {
-
-		bool shoot = false;
-
-        if (IsKeyPressed('P') || btnPause.isClicked()) pause = !pause;
+        if (input.pausePressed || btnPause.isClicked(input.clickPressed)) pause = !pause;
 
 		if (btnPause.isHovered()) {
 			btnPause.setTexture(btnPauseTextureHover);
@@ -269,56 +323,62 @@ void UpdateGame(void)
 			btnDebug.setTexture(btnDebugTexture);
 		}
 
-		if (btnDebug.isClicked()) debug = !debug;
-
-        if (!pause)
-        {
-
-            UpdatePlayer();
-						
-
-			if (IsKeyDown(KEY_SPACE)) {
-				double delta = GetTime() - shotTime;
-
-				if (delta > SHOOTING_DELAY) {
-					shoot = true;
-                	shotTime = GetTime();
-				}				
-			}
+		if (btnDebug.isClicked(input.clickPressed)) debug = !debug;
 
-			if (shoot) Shoot();
-
-			UpdateBullets(bullets);
-
-			UpdateAsteroids(asteroids);
+		if (pause && input.restartPressed) RestartGame();
+	}
+	else {
+		if (input.restartPressed) RestartGame();
+	}
 
-			if (asteroids.size() == 0) {
-				for (int i = 0; i < random_int(2, 6); i++) {
-					SpawnAsteroid(2, Vector2{ (float)random_int(0, screenWidth), (float)random_int(0, screenHeight) });	
-				}
-			}
-		}
-		else
-    	{
-			if (IsKeyPressed(KEY_ENTER))
-			{
-				UnloadGame();
-				InitGame();
-			}
-    	}
+	// Hand the input to the simulation
+	SimulationInput simulationInput = { 0 };
+	simulationInput.rotateLeft = input.rotateLeft;
+	simulationInput.rotateRight = input.rotateRight;
+	simulationInput.thrust = input.thrust;
+	simulationInput.brake = input.brake;
+	simulationInput.shoot = input.shoot;
+	simulationInput.startScreen = startScreen;
+	simulationInput.pause = pause;
+	simulationInput.restart = restartCount;
+	simulationInput.time = input.time;
+
+	if (pipelined) {
+		SetSimulationInput(simulationInput);
 	}
 	else {
-		if (IsKeyPressed(KEY_ENTER))
-		{
-			UnloadGame();
-			InitGame();
-		}
+		double tickStart = GetTime();
+		TickSimulation(simulationInput, GetFrameTime());
+		PublishSnapshot((float)(GetTime() - tickStart));
 	}
+
+	// Draw the newest finished tick
+	frame = &ConsumeSnapshot();
+	shipInputTime = frame->inputTime;
+
+	UpdateWorldCamera();
+	UpdateSpatialIndex();
 }
 
 // Draw game (one frame)
 void DrawGame()
 {
+	TRACE_FUNCTION();
+
+	double drawStart = GetTime();
+	float renderScale = governor.renderScale();
+
+	UpdateHudText();
+
+	// Render the world at a lower resolution when the governor asks for it
+	if (!frame->gameOver && !startScreen && renderScale < 1.0f)
+	{
+		BeginTextureMode(worldTarget);
+			ClearBackground(RAYWHITE);
+			DrawWorld(renderScale);
+		EndTextureMode();
+	}
+
     BeginDrawing();
 
         ClearBackground(RAYWHITE);
@@ -330,16 +390,22 @@ void DrawGame()
 			startButton.Draw();
 		}
 
-		if (!gameOver && !startScreen)
+		if (!frame->gameOver && !startScreen)
 		{
-			// Draw bullets
-			DrawBullets(bullets);
-
-			// Draw asteroids
-			DrawAsteroids(asteroids);
-
-			// Draw Player
-			DrawPlayer();
+			if (renderScale < 1.0f) {
+				// Upscale the top-left part of the (y-flipped) world target to the screen
+				DrawTexturePro(
+					worldTarget.texture,
+					Rectangle {0, (float)screenHeight * (1.0f - renderScale), (float)screenWidth * renderScale, -(float)screenHeight * renderScale},
+					Rectangle {0, 0, (float)screenWidth, (float)screenHeight},
+					Vector2 {0, 0},
+					0.0f,
+					WHITE
+				);
+			}
+			else {
+				DrawWorld(1.0f);
+			}
 
 			// Draw score
 			DisplayScore();
@@ -347,6 +413,9 @@ void DrawGame()
 			// Draw Player Lives
 			DrawPlayerLives();
 
+			// Draw minimap
+			DrawMinimap();
+
 			// Draw button
 			btnPause.Draw();
 			btnDebug.Draw();
@@ -356,26 +425,49 @@ void DrawGame()
 				DrawDebugInfo();
 			}
 		}
-		else if (gameOver)
+		else if (frame->gameOver)
 		{
 			// Draw game over banner
 			DrawTexture(gameOverTexture, (screenWidth/2) - (gameOverTexture.width/2), (screenHeight/2) - (gameOverTexture.height/2), WHITE);
 		}
 
-        if (!gameOver)
+        if (!frame->gameOver)
         {
             if (victory) DrawText("VICTORY", screenWidth/2 - MeasureText("VICTORY", 20)/2, screenHeight/2, 20, LIGHTGRAY);
             if (pause) DrawText("GAME PAUSED", screenWidth/2 - MeasureText("GAME PAUSED", 40)/2, screenHeight/2 - 40, 40, Color{150, 150, 150, 255});
         }
 
-    EndDrawing();
+	// Submit the batched draw calls here so their cost is measured; EndDrawing would
+	// flush them after drawTime is taken
+	{
+		TRACE_SCOPE("FlushBatch");
+		rlDrawRenderBatchActive();
+	}
+
+	drawTime = GetTime() - drawStart;
+
+	// The draw calls were just submitted. Still missing: the swap in EndDrawing, GPU
+	// execution and scan-out, which raylib gives no timestamp for without custom frame control
+	if (measureLatency && !frame->gameOver && !startScreen) {
+		latencyMeter.record(GetTime() - shipInputTime, GetTime());
+	}
+
+	{
+		// Buffer swap, frame wait and input polling
+		TRACE_SCOPE("EndDrawing");
+    	EndDrawing();
+	}
 }
 
 // Unload game variables
 void UnloadGame()
 {
+	TRACE_FUNCTION();
+
 	UnloadTexture(playerTexture);
+	UnloadTexture(playerTextureFlight);
 	UnloadTexture(startText.texture);
+	UnloadTexture(gameOverTexture);
 	UnloadTexture(btnPauseTexture);
 	UnloadTexture(btnPauseTextureHover);
 	UnloadTexture(btnDebugTexture);
@@ -383,92 +475,191 @@ void UnloadGame()
 	UnloadTexture(startButtonTexture);
 	UnloadTexture(startButtonTextureHover);
 	UnloadTexture(bulletTexture);
-
+	UnloadTexture(asteroidTexture1);
+	UnloadTexture(asteroidTexture2);
+	UnloadTexture(asteroidTexture3);
 }
 
 // Update and Draw (one frame)
 void UpdateDrawFrame()
 {
+	TRACE_FUNCTION();
+
+	double updateStart = GetTime();
     UpdateGame();
+	double updateTime = GetTime() - updateStart;
+
     DrawGame();
+
+	// Pipelined, the simulation tick overlaps the whole main thread frame
+	// GetFrameTime() includes the swap, so GPU bound frames show up there even when
+	// the CPU time fits the budget
+	if (pipelined) governor.recordFrame(frame->updateTime, (float)(updateTime + drawTime), GetFrameTime());
+	else governor.recordFrame((float)updateTime, (float)drawTime, GetFrameTime());
+}
+
+void UpdateWorldCamera() {
+	// Follow the player, but keep the view inside the world
+	cameraTarget = frame->player.position;
+
+	if (cameraTarget.x < screenWidth / 2) cameraTarget.x = screenWidth / 2;
+	else if (cameraTarget.x > worldWidth - screenWidth / 2) cameraTarget.x = worldWidth - screenWidth / 2;
+	if (cameraTarget.y < screenHeight / 2) cameraTarget.y = screenHeight / 2;
+	else if (cameraTarget.y > worldHeight - screenHeight / 2) cameraTarget.y = worldHeight - screenHeight / 2;
+}
+
+void UpdateSpatialIndex() {
+	TRACE_FUNCTION();
+
+	bulletGrid.clear();
+	for (int i = 0; i < frame->bullets.size(); i++) {
+		bulletGrid.insert(i, frame->bullets[i].position, frame->bullets[i].radius);
+	}
+
+	asteroidGrid.clear();
+	for (int i = 0; i < frame->asteroids.size(); i++) {
+		asteroidGrid.insert(i, frame->asteroids[i].position, frame->asteroids[i].radius);
+	}
+}
+
+Rectangle GetViewRect() {
+	return Rectangle {
+		cameraTarget.x - screenWidth / 2,
+		cameraTarget.y - screenHeight / 2,
+		(float)screenWidth,
+		(float)screenHeight
+	};
+}
+
+void DrawWorld(float renderScale) {
+	TRACE_FUNCTION();
+
+	Camera2D camera = { 0 };
+	camera.offset = Vector2 { screenWidth / 2 * renderScale, screenHeight / 2 * renderScale };
+	camera.target = cameraTarget;
+	camera.rotation = 0.0f;
+	camera.zoom = renderScale;
+
+	drawnEntities = 0;
+
+	BeginMode2D(camera);
+
+		// Draw bullets
+		DrawBullets(frame->bullets);
+
+		// Draw asteroids
+		DrawAsteroids(frame->asteroids);
+
+		// Draw Player
+		DrawPlayer();
+
+	EndMode2D();
+}
+
+void DrawMinimap() {
+	TRACE_FUNCTION();
+
+	float minimapScale = (float)MINIMAP_WIDTH / worldWidth;
+	Rectangle minimap = { 0 };
+	minimap.width = MINIMAP_WIDTH;
+	minimap.height = worldHeight * minimapScale;
+	minimap.x = screenWidth - minimap.width - 15;
+	minimap.y = screenHeight - minimap.height - 15;
+
+	DrawRectangleRec(minimap, Color{ 0, 0, 0, 40 });
+
+	// One mark per occupied grid cell, so the cost does not grow with the asteroid count
+	float cellSize = asteroidGrid.cellSize * minimapScale;
+	for (int row = 0; row < asteroidGrid.rows; row++) {
+		for (int column = 0; column < asteroidGrid.columns; column++) {
+			if (asteroidGrid.getCellCount(column, row) > 0) {
+				DrawRectangleRec(Rectangle { minimap.x + column * cellSize, minimap.y + row * cellSize, cellSize, cellSize }, Color{ 255, 71, 96, 175 });
+			}
+		}
+	}
+
+	// Player and view
+	Rectangle view = GetViewRect();
+	DrawRectangleLinesEx(Rectangle { minimap.x + view.x * minimapScale, minimap.y + view.y * minimapScale, view.width * minimapScale, view.height * minimapScale }, 1.0f, DARKGRAY);
+	DrawCircleV(Vector2 { minimap.x + frame->player.position.x * minimapScale, minimap.y + frame->player.position.y * minimapScale }, 3.0f, Color{ 61, 168, 255, 255 });
+	DrawRectangleLinesEx(minimap, 1.0f, BLACK);
+}
+
+void UpdateHudText() {
+	TRACE_FUNCTION();
+
+	// Only rebuild the HUD strings as often as the governor allows
+	if (GetTime() - hudRefreshTime < governor.hudRefreshInterval()) return;
+	hudRefreshTime = GetTime();
+
+	hudText.score = std::to_string(frame->score);
+	hudText.wave = "WAVE " + std::to_string(frame->wave);
+	hudText.fps = std::to_string(GetFPS());
+	hudText.acceleration = std::to_string(frame->player.acceleration);
+	hudText.rotation = std::to_string(frame->player.rotation);
+	hudText.bulletCount = std::to_string(frame->bullets.size());
+	hudText.drawnCount = std::to_string(drawnEntities) + " / " + std::to_string(frame->bullets.size() + frame->asteroids.size());
+	hudText.quality = governor.getLevelName();
+	hudText.latency = measureLatency ? TextFormat("%.2f ms (max %.2f)", latencyMeter.average * 1000.0, latencyMeter.maximum * 1000.0) : "off";
 }
 
 void DrawDebugInfo() {
+	TRACE_FUNCTION();
+
 	// Draw FPS
 	DrawText("FPS:", 10, 10, 20, BLACK);
-	DrawText(std::to_string(GetFPS()).c_str(), MeasureText("FPS:", 20) + 20, 10, 20, GREEN);
+	DrawText(hudText.fps.c_str(), MeasureText("FPS:", 20) + 20, 10, 20, GREEN);
 				
 	// Draw player acceleration
 	DrawText("Acceleration:", 10, 30, 20, BLACK);
-	DrawText(std::to_string(player.acceleration).c_str(), MeasureText("Acceleration:", 20) + 20, 30, 20, BLACK);
+	DrawText(hudText.acceleration.c_str(), MeasureText("Acceleration:", 20) + 20, 30, 20, BLACK);
 
 	// Draw player rotation		
 	DrawText("Rotation:", 10, 50, 20, BLACK);
-	DrawText(std::to_string(player.rotation).c_str(), MeasureText("Rotation:", 20) + 20, 50, 20, BLACK);
+	DrawText(hudText.rotation.c_str(), MeasureText("Rotation:", 20) + 20, 50, 20, BLACK);
 
 	// Draw Bullet count		
 	DrawText("Bullet count:", 10, 70, 20, BLACK);
-	DrawText(std::to_string(bullets.size()).c_str(), MeasureText("Bullet count:", 20) + 20, 70, 20, BLACK);
-}
+	DrawText(hudText.bulletCount.c_str(), MeasureText("Bullet count:", 20) + 20, 70, 20, BLACK);
 
-void UpdatePlayer() {
-	// Player logic: rotation
-    if (IsKeyDown(KEY_LEFT) || IsKeyDown(KEY_A)) player.rotation -= PLAYER_ROTATION_SPEED * GetFrameTime();
-    if (IsKeyDown(KEY_RIGHT) || IsKeyDown(KEY_D)) player.rotation += PLAYER_ROTATION_SPEED * GetFrameTime();
-	if (player.rotation > 360) player.rotation -= 360;
-	if (player.rotation < -360) player.rotation += 360;
+	// Draw governor quality level
+	DrawText("Quality:", 10, 90, 20, BLACK);
+	DrawText(hudText.quality.c_str(), MeasureText("Quality:", 20) + 20, 90, 20, BLACK);
 
-    // Player logic: speed
-    player.speed.x = sin(player.rotation*DEG2RAD)*PLAYER_SPEED * GetFrameTime() ;
-    player.speed.y = cos(player.rotation*DEG2RAD)*PLAYER_SPEED * GetFrameTime();
-
-    // Player logic: acceleration
-    if (IsKeyDown(KEY_UP) || IsKeyDown(KEY_W))
-    {
-		playerFlying = true;
+	// Draw culled entity count
+	DrawText("Drawn:", 10, 110, 20, BLACK);
+	DrawText(hudText.drawnCount.c_str(), MeasureText("Drawn:", 20) + 20, 110, 20, BLACK);
 
-        if (player.acceleration < PLAYER_MAX_ACCELERATION) player.acceleration += PLAYER_ACCELERATION * ( DRAG * 2);
-		else if (player.acceleration > PLAYER_MAX_ACCELERATION) player.acceleration = PLAYER_MAX_ACCELERATION;
-	}
-    else
-    {
-		playerFlying = false;
+	// Draw input-to-submit latency
+	DrawText("Latency:", 10, 130, 20, BLACK);
+	DrawText(hudText.latency.c_str(), MeasureText("Latency:", 20) + 20, 130, 20, BLACK);
+}
 
-        if (player.acceleration > 0) player.acceleration -= DRAG;
-        else if (player.acceleration < 0) player.acceleration = 0;
-    }
-    if (IsKeyDown(KEY_DOWN) || IsKeyDown(KEY_S))
-    {
-        if (player.acceleration > 0) player.acceleration -= PLAYER_ACCELERATION / 2;
-        else if (player.acceleration < 0) player.acceleration = 0;
-    }
+void DrawPlayer() {
+	TRACE_FUNCTION();
 
-    // Player logic: movement
-    player.position.x += (player.speed.x * player.acceleration);
-    player.position.y -= (player.speed.y * player.acceleration);
+	float rotation = frame->player.rotation;
+	bool flying = frame->playerFlying;
 
-    // Collision logic: player vs walls
-    if (player.position.x > screenWidth + shipHeight) player.position.x = -(shipHeight);
-    else if (player.position.x < -(shipHeight)) player.position.x = screenWidth + shipHeight;
-    if (player.position.y > (screenHeight + shipHeight)) player.position.y = -(shipHeight);
-    else if (player.position.y < -(shipHeight)) player.position.y = screenHeight + shipHeight;
+	// Late latch: redo this frame's rotation step and thrust flame with input read just now
+	if (lateLatch && !pause) {
+		InputSnapshot latched = LatchInput();
+		float latchedRotationInput = (latched.rotateRight ? 1.0f : 0.0f) - (latched.rotateLeft ? 1.0f : 0.0f);
 
-	// Player Lives:
-	if (lives == -1) {
-		gameOver = true;
+		rotation += (latchedRotationInput - frame->playerRotationInput) * PLAYER_ROTATION_SPEED * frame->tickDelta;
+		flying = latched.thrust;
+		shipInputTime = latched.time;
 	}
-}
 
-void DrawPlayer() {
 	// Draw player
-	if (playerFlying) {
+	if (flying) {
 		
 		DrawTexturePro(
 			playerTextureFlight, 
 			Rectangle {1, 1, (float)playerTextureFlight.width, (float)playerTextureFlight.height}, 
-			Rectangle {player.position.x, player.position.y, (float)playerTextureFlight.width * PLAYER_SIZE, (float)playerTextureFlight.height * PLAYER_SIZE}, 
+			Rectangle {frame->player.position.x, frame->player.position.y, (float)playerTextureFlight.width * PLAYER_SIZE, (float)playerTextureFlight.height * PLAYER_SIZE}, 
 			Vector2 {(float)playerTextureFlight.width * PLAYER_SIZE / 2, (float)playerTextureFlight.height * PLAYER_SIZE / 2}, 
-			player.rotation,
+			rotation,
 			WHITE
 		);
 	}
@@ -476,47 +667,19 @@ void DrawPlayer() {
 		DrawTexturePro(
 			playerTexture, 
 			Rectangle {1, 1, (float)playerTexture.width, (float)playerTexture.height}, 
-			Rectangle {player.position.x, player.position.y, (float)playerTexture.width * PLAYER_SIZE, (float)playerTexture.height * PLAYER_SIZE}, 
+			Rectangle {frame->player.position.x, frame->player.position.y, (float)playerTexture.width * PLAYER_SIZE, (float)playerTexture.height * PLAYER_SIZE}, 
 			Vector2 {(float)playerTexture.width * PLAYER_SIZE / 2, (float)playerTexture.height * PLAYER_SIZE / 2}, 
-			player.rotation,
+			rotation,
 			WHITE
 		);
 	}
 
-	if (debug) {
-		DrawCircleV(player.position,  playerTexture.width * PLAYER_SIZE / 2, Color{ 61, 168, 255, 175 });
+	if (debug && governor.drawDebugShapes()) {
+		DrawCircleV(frame->player.position,  playerTexture.width * PLAYER_SIZE / 2, Color{ 61, 168, 255, 175 });
 	}
 }
 
 
-void Shoot() {
-	// Bullet logic: spawn
-	Bullet bullet;
-	bullet.position = Vector2 { player.position.x + sin(player.rotation*DEG2RAD)*shipHeight, player.position.y - cos(player.rotation*DEG2RAD)*shipHeight };
-	bullet.speed.x = BULLET_SPEED*sin(player.rotation*DEG2RAD)*PLAYER_SPEED * GetFrameTime();
-	bullet.speed.y = BULLET_SPEED*cos(player.rotation*DEG2RAD)*PLAYER_SPEED * GetFrameTime();
-	bullet.rotation = player.rotation;
-	bullet.radius = bulletTexture.width * BULLET_SIZE / 2;
-
-	// Add bullet to list
-	bullets.push_back(bullet);
-}
-
-void UpdateBullets(std::vector<Bullet> &bullets) {
-	// Bullet logic: movement
-	for (int i = 0; i < bullets.size(); i++) {
-		// Bullet logic: collision with screen borders
-		if (bullets[i].position.x < -bullets[i].radius || bullets[i].position.x > screenWidth + bullets[i].radius || bullets[i].position.y < -bullets[i].radius || bullets[i].position.y > screenHeight + bullets[i].radius) {
-			bullets.erase(bullets.begin() + i);
-		}
-		else {
-			// Movement
-			bullets[i].position.x += bullets[i].speed.x * GetFrameTime();
-			bullets[i].position.y -= bullets[i].speed.y * GetFrameTime();
-		}
-	}
-}
-
 void DrawBullet(Bullet bullet) {
 	DrawTexturePro(
 		bulletTexture,
@@ -527,49 +690,26 @@ void DrawBullet(Bullet bullet) {
 		WHITE
 	);
 
-	if (debug) {
+	if (debug && governor.drawDebugShapes()) {
 		DrawCircleV(bullet.position, bullet.radius, Color{ 0, 228, 48, 175 });
 	}
 }
 
-void DrawBullets(std::vector<Bullet> bullets) {
-	for (int i = 0; i < bullets.size(); i++) {
-		DrawBullet(bullets[i]);
-	}
-}
-
-void SpawnAsteroid(int status, Vector2 position) {
-	// Asteroid logic: spawn
-	std::vector<Texture2D> asteroidTextures = { asteroidTexture1, asteroidTexture2, asteroidTexture3 }; // Asteroid textures
-	Texture2D rand_text = asteroidTextures[random_int(0, asteroidTextures.size() - 1)]; // Random asteroid texture
+void DrawBullets(std::vector<Bullet> &bullets) {
+	TRACE_FUNCTION();
 
-	Asteroid asteroid; 
-	asteroid.texture = rand_text;
-	asteroid.rotation = random_int(0, 360); // Random rotation
-
-	asteroid.speed = Vector2 { // random speed
-		(float)random_dbl(ASTEROID_MIN_SPEED, ASTEROID_MAX_SPEED)*sin(asteroid.rotation*DEG2RAD), 
-		(float)random_dbl(ASTEROID_MIN_SPEED, ASTEROID_MAX_SPEED)*cos(asteroid.rotation*DEG2RAD) 
-	};
-
-	asteroid.position = position;
-	asteroid.status = status;
-	
-	switch (status) {
-		case 2:
-			asteroid.radius = (float)(rand_text.width * ASTEROID_BIG_SIZE) / 2;
-			break;
+	// Only draw bullets inside the view
+	Rectangle view = GetViewRect();
+	bulletGrid.query(view, visibleIds);
 
-		case 1:
-			asteroid.radius = (float)(rand_text.width * ASTEROID_MEDIUM_SIZE) / 2;
-			break;
+	for (int i = 0; i < visibleIds.size(); i++) {
+		Bullet &bullet = bullets[visibleIds[i]];
 
-		case 0:
-			asteroid.radius = (float)(rand_text.width * ASTEROID_SMALL_SIZE) / 2;
-			break;
+		if (CheckCollisionCircleRec(bullet.position, bullet.radius, view)) {
+			DrawBullet(bullet);
+			drawnEntities++;
+		}
 	}
-	
-	asteroids.push_back(asteroid); // Add asteroid to list
 }
 
 void DrawAsteroid(Asteroid asteroid) {
@@ -610,81 +750,53 @@ void DrawAsteroid(Asteroid asteroid) {
 			break;
 	}
 
-	if (debug) {
+	if (debug && governor.drawDebugShapes()) {
 		DrawCircleV(asteroid.position, asteroid.radius, Color{255, 71, 96, 175});
 	}
 }
 
-void DrawAsteroids(std::vector<Asteroid> asteroids) {
-	for (int i = 0; i < asteroids.size(); i++) {
-		DrawAsteroid(asteroids[i]);
-	}
-}
+void DrawAsteroids(std::vector<Asteroid> &asteroids) {
+	TRACE_FUNCTION();
 
-void UpdateAsteroids(std::vector<Asteroid> &asteroids) {
-	if (!startScreen) {
-		for (int i = 0; i < asteroids.size(); i++) {
-			// Movement
-			asteroids[i].position.x += asteroids[i].speed.x * GetFrameTime();
-			asteroids[i].position.y -= asteroids[i].speed.y * GetFrameTime();
-
-			// Check if asteroid is out of screen bounds 
-			if (asteroids[i].position.x > screenWidth + asteroids[i].radius) asteroids[i].position.x = -(asteroids[i].radius);
-			else if (asteroids[i].position.x < -(asteroids[i].radius)) asteroids[i].position.x = screenWidth + asteroids[i].radius;
-			if (asteroids[i].position.y > (screenHeight + asteroids[i].radius)) asteroids[i].position.y = -(asteroids[i].radius);
-			else if (asteroids[i].position.y < -(asteroids[i].radius)) asteroids[i].position.y = screenHeight + asteroids[i].radius;
-
-			// Check if asteroid is colliding with player
-			if (CheckCollisionCircles(asteroids[i].position, asteroids[i].radius, player.position, playerTexture.width * PLAYER_SIZE / 2.5)) {
-				asteroids.erase(asteroids.begin() + i);
-				lives--;
-			}
+	// Only draw asteroids inside the view
+	Rectangle view = GetViewRect();
+	asteroidGrid.query(view, visibleIds);
 
-			// Check if asteroid is colliding with bullets
-			for (int j = 0; j < bullets.size(); j++) {
-				if (CheckCollisionCircles(asteroids[i].position, asteroids[i].radius, bullets[j].position, bullets[j].radius)) {
-					bullets.erase(bullets.begin() + j);
-					
-					if (asteroids[i].status == 2) {
-
-						for (int k = 0; k < random_int(2, 3); k++) {
-							SpawnAsteroid(1, asteroids[i].position);
-						}
-						
-						asteroids.erase(asteroids.begin() + i);
-					}
-					else if (asteroids[i].status == 1) {
-						
-						for (int k = 0; k < random_int(2, 3); k++) {
-							SpawnAsteroid(0, asteroids[i].position);
-						}
-
-						asteroids.erase(asteroids.begin() + i);
-					}
-					else if (asteroids[i].status == 0) {
-						asteroids.erase(asteroids.begin() + i);
-						score += 1;
-					}
-
-				}
-			}
+	for (int i = 0; i < visibleIds.size(); i++) {
+		Asteroid &asteroid = asteroids[visibleIds[i]];
+
+		if (CheckCollisionCircleRec(asteroid.position, asteroid.radius, view)) {
+			DrawAsteroid(asteroid);
+			drawnEntities++;
 		}
 	}
 }
 
 void DisplayScore() {
+	TRACE_FUNCTION();
+
 	DrawText(
-		std::to_string(score).c_str(),
-		screenWidth / 2 - MeasureText(std::to_string(score).c_str(), 80) / 2,
+		hudText.score.c_str(),
+		screenWidth / 2 - MeasureText(hudText.score.c_str(), 80) / 2,
 		40,
 		80,
 		BLACK
 	);
+
+	DrawText(
+		hudText.wave.c_str(),
+		screenWidth / 2 - MeasureText(hudText.wave.c_str(), 20) / 2,
+		125,
+		20,
+		DARKGRAY
+	);
 }
 
 void DrawPlayerLives() {
+	TRACE_FUNCTION();
+
 	if (!debug) {	
-		for (int i = 1; i <= lives; i++) {
+		for (int i = 1; i <= frame->lives; i++) {
 
 			DrawTextureEx(
 				playerTexture,
@@ -699,13 +811,13 @@ void DrawPlayerLives() {
 		}
 	}
 	else {
-		for (int i = 1; i <= lives; i++) {
+		for (int i = 1; i <= frame->lives; i++) {
 
 			DrawTextureEx(
 				playerTexture,
 				Vector2 {
 					(float)((i * playerTexture.width * PLAYER_SIZE)),
-					100.0f,
+					160.0f,
 				},
 				0.0f,
 				PLAYER_SIZE,
@@ -713,25 +825,4 @@ void DrawPlayerLives() {
 			);
 		}
 	}
-}
-
-int random_int(int range_from, int range_to) {
-    std::random_device                  rand_dev;
-    std::mt19937                        generator(rand_dev());
-    std::uniform_int_distribution<int>    distr(range_from, range_to);
-    return distr(generator);
-}
-
-double random_dbl(double range_from, double range_to) {
-	std::random_device                  rand_dev;
-	std::mt19937                        generator(rand_dev());
-	std::uniform_real_distribution<double>    distr(range_from, range_to);
-	return distr(generator);
-}
-
-float random_flt(float range_from, float range_to) {
-	std::random_device                  rand_dev;
-	std::mt19937                        generator(rand_dev());
-	std::uniform_real_distribution<float>    distr(range_from, range_to);
-	return distr(generator);
 }
\ No newline at end of file
@@ -0,0 +1,444 @@
+#include "simulation.hpp"
+
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <math.h>
+#include "trace.hpp"
+#include "triple_buffer.hpp"
+#include "spatial_grid.hpp"
+#include "audio_mixer.hpp"
+
+using namespace std::chrono;
+
+//--------
+// Globals
+//--------
+
+// === World ===
+const int worldWidth = 3000;
+const int worldHeight = 2400;
+
+int score = 0;
+int lives = 3;
+bool gameOver = false;
+
+static double simulationTime = 0.0;		// seconds simulated since the last reset
+static double inputTime = 0.0;			// sample time of the input used by the last tick
+static float tickDelta = 0.0f;			// delta of the last tick, 0 when it did not move the ship
+static unsigned int restart = 0;		// last restart request applied
+
+// === Player ===
+Player player = { 0 };
+float playerHitRadius = 0.0f;
+float shipHeight = 0.0f;
+bool playerFlying = false;
+float playerRotationInput = 0.0f;
+
+// === Bullets ===
+float bulletRadius = 0.0f;
+std::vector<Bullet> bullets;
+
+static double shotTime = -SHOOTING_DELAY;
+
+// === Asteroids ===
+Texture2D asteroidTexture1;
+Texture2D asteroidTexture2;
+Texture2D asteroidTexture3;
+std::vector<Asteroid> asteroids;
+
+// === Spawning ===
+WaveDirector waveDirector(std::vector<WaveDefinition>(), SPAWN_BUDGET);
+static SpatialGrid spawnGrid(worldWidth, worldHeight, WORLD_CELL_SIZE);
+static std::vector<SpawnRequest> dueSpawns;
+static std::vector<int> nearbyIds;
+
+// === Pipelining ===
+static TripleBuffer<SimulationInput> simulationInputs;
+static TripleBuffer<RenderSnapshot> snapshots;
+static std::atomic<bool> simulationRunning{ false };
+static std::thread simulationThread;
+
+//-----------
+// Functions
+//-----------
+
+void ResetSimulation() {
+	gameOver = false;
+	score = 0;
+	lives = 3;
+	simulationTime = 0.0;
+	tickDelta = 0.0f;
+	shotTime = -SHOOTING_DELAY;
+
+	player.position = Vector2 { worldWidth / 2.0f, worldHeight / 2.0f };
+	player.speed = Vector2 { 0, 0 };
+	player.acceleration = 0;
+	player.rotation = 0;
+	if (playerFlying) audioMixer.stop(SOUND_THRUST);
+	playerFlying = false;
+	playerRotationInput = 0.0f;
+
+	bullets.clear();
+	asteroids.clear();
+	waveDirector.reset();
+}
+
+// Largest radius an asteroid of this status can get
+static float AsteroidRadius(int status) {
+	float width = fmaxf(asteroidTexture1.width, fmaxf(asteroidTexture2.width, asteroidTexture3.width));
+
+	switch (status) {
+		case 2: return width * ASTEROID_BIG_SIZE / 2;
+		case 1: return width * ASTEROID_MEDIUM_SIZE / 2;
+	}
+	return width * ASTEROID_SMALL_SIZE / 2;
+}
+
+// Pick a random spot away from the player that does not overlap another asteroid
+static bool FindSpawnPosition(float radius, Vector2 &position) {
+	for (int attempt = 0; attempt < SPAWN_ATTEMPTS; attempt++) {
+		Vector2 candidate = { random_flt(radius, worldWidth - radius), random_flt(radius, worldHeight - radius) };
+
+		if (CheckCollisionCircles(candidate, radius, player.position, SPAWN_SAFE_RADIUS)) continue;
+
+		bool blocked = false;
+		spawnGrid.query(Rectangle{ candidate.x - radius, candidate.y - radius, radius * 2, radius * 2 }, nearbyIds);
+		for (int i = 0; i < nearbyIds.size() && !blocked; i++) {
+			Asteroid &other = asteroids[nearbyIds[i]];
+			blocked = CheckCollisionCircles(candidate, radius, other.position, other.radius);
+		}
+
+		if (!blocked) {
+			position = candidate;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Spawn what the wave director hands out this tick
+static void SpawnDue(float delta) {
+	TRACE_FUNCTION();
+
+	waveDirector.takeDue(delta, dueSpawns);
+	if (dueSpawns.empty()) return;
+
+	spawnGrid.clear();
+	for (int i = 0; i < asteroids.size(); i++) {
+		spawnGrid.insert(i, asteroids[i].position, asteroids[i].radius);
+	}
+
+	for (int i = 0; i < dueSpawns.size(); i++) {
+		SpawnRequest &request = dueSpawns[i];
+		Vector2 position = request.position;
+
+		if (request.placeFreely && !FindSpawnPosition(AsteroidRadius(request.status), position)) {
+			waveDirector.requeue(request);
+			continue;
+		}
+
+		SpawnAsteroid(request.status, position, request.speedScale);
+		spawnGrid.insert(asteroids.size() - 1, position, asteroids.back().radius);
+	}
+}
+
+void TickSimulation(const SimulationInput &input, float delta) {
+	TRACE_FUNCTION();
+
+	// A restart is a counter rather than a flag so it survives being overwritten by newer input
+	if (input.restart != restart) {
+		restart = input.restart;
+		ResetSimulation();
+	}
+
+	simulationTime += delta;
+	inputTime = input.time;
+	tickDelta = 0.0f;
+
+	if (gameOver || input.pause) {
+		// Silence the engine while nothing moves
+		if (playerFlying) audioMixer.stop(SOUND_THRUST);
+		playerFlying = false;
+		return;
+	}
+
+	tickDelta = delta;
+	UpdatePlayer(input, delta);
+
+	if (input.shoot && simulationTime - shotTime > SHOOTING_DELAY) {
+		shotTime = simulationTime;
+		Shoot(delta);
+	}
+
+	UpdateBullets(bullets, delta);
+
+	if (!input.startScreen) UpdateAsteroids(asteroids, delta);
+
+	if (asteroids.size() == 0 && waveDirector.isIdle()) waveDirector.startWave();
+
+	SpawnDue(delta);
+}
+
+void UpdatePlayer(const SimulationInput &input, float delta) {
+	TRACE_FUNCTION();
+
+	// Player logic: rotation
+	playerRotationInput = (input.rotateRight ? 1.0f : 0.0f) - (input.rotateLeft ? 1.0f : 0.0f);
+    if (input.rotateLeft) player.rotation -= PLAYER_ROTATION_SPEED * delta;
+    if (input.rotateRight) player.rotation += PLAYER_ROTATION_SPEED * delta;
+	if (player.rotation > 360) player.rotation -= 360;
+	if (player.rotation < -360) player.rotation += 360;
+
+    // Player logic: speed
+    player.speed.x = sin(player.rotation*DEG2RAD)*PLAYER_SPEED * delta;
+    player.speed.y = cos(player.rotation*DEG2RAD)*PLAYER_SPEED * delta;
+
+    // Player logic: acceleration
+    if (input.thrust)
+    {
+		if (!playerFlying) audioMixer.play(SOUND_THRUST);
+		playerFlying = true;
+
+        if (player.acceleration < PLAYER_MAX_ACCELERATION) player.acceleration += PLAYER_ACCELERATION * ( DRAG * 2);
+		else if (player.acceleration > PLAYER_MAX_ACCELERATION) player.acceleration = PLAYER_MAX_ACCELERATION;
+	}
+    else
+    {
+		if (playerFlying) audioMixer.stop(SOUND_THRUST);
+		playerFlying = false;
+
+        if (player.acceleration > 0) player.acceleration -= DRAG;
+        else if (player.acceleration < 0) player.acceleration = 0;
+    }
+    if (input.brake)
+    {
+        if (player.acceleration > 0) player.acceleration -= PLAYER_ACCELERATION / 2;
+        else if (player.acceleration < 0) player.acceleration = 0;
+    }
+
+    // Player logic: movement
+    player.position.x += (player.speed.x * player.acceleration);
+    player.position.y -= (player.speed.y * player.acceleration);
+
+    // Collision logic: player vs walls
+    if (player.position.x > worldWidth + shipHeight) player.position.x = -(shipHeight);
+    else if (player.position.x < -(shipHeight)) player.position.x = worldWidth + shipHeight;
+    if (player.position.y > (worldHeight + shipHeight)) player.position.y = -(shipHeight);
+    else if (player.position.y < -(shipHeight)) player.position.y = worldHeight + shipHeight;
+
+	// Player Lives:
+	if (lives == -1) {
+		gameOver = true;
+	}
+}
+
+void Shoot(float delta) {
+	TRACE_FUNCTION();
+
+	// Bullet logic: spawn
+	Bullet bullet;
+	bullet.position = Vector2 { player.position.x + sin(player.rotation*DEG2RAD)*shipHeight, player.position.y - cos(player.rotation*DEG2RAD)*shipHeight };
+	bullet.speed.x = BULLET_SPEED*sin(player.rotation*DEG2RAD)*PLAYER_SPEED * delta;
+	bullet.speed.y = BULLET_SPEED*cos(player.rotation*DEG2RAD)*PLAYER_SPEED * delta;
+	bullet.rotation = player.rotation;
+	bullet.radius = bulletRadius;
+
+	// Add bullet to list
+	bullets.push_back(bullet);
+	audioMixer.play(SOUND_SHOT);
+}
+
+void UpdateBullets(std::vector<Bullet> &bullets, float delta) {
+	TRACE_FUNCTION();
+
+	// Bullet logic: movement
+	for (int i = 0; i < bullets.size(); i++) {
+		// Bullet logic: collision with world borders
+		if (bullets[i].position.x < -bullets[i].radius || bullets[i].position.x > worldWidth + bullets[i].radius || bullets[i].position.y < -bullets[i].radius || bullets[i].position.y > worldHeight + bullets[i].radius) {
+			bullets.erase(bullets.begin() + i);
+		}
+		else {
+			// Movement
+			bullets[i].position.x += bullets[i].speed.x * delta;
+			bullets[i].position.y -= bullets[i].speed.y * delta;
+		}
+	}
+}
+
+void SpawnAsteroid(int status, Vector2 position, float speedScale) {
+	TRACE_FUNCTION();
+
+	// Asteroid logic: spawn
+	std::vector<Texture2D> asteroidTextures = { asteroidTexture1, asteroidTexture2, asteroidTexture3 }; // Asteroid textures
+	Texture2D rand_text = asteroidTextures[random_int(0, asteroidTextures.size() - 1)]; // Random asteroid texture
+
+	Asteroid asteroid; 
+	asteroid.texture = rand_text;
+	asteroid.rotation = random_int(0, 360); // Random rotation
+
+	asteroid.speed = Vector2 { // random speed
+		(float)random_dbl(ASTEROID_MIN_SPEED, ASTEROID_MAX_SPEED)*sin(asteroid.rotation*DEG2RAD)*speedScale, 
+		(float)random_dbl(ASTEROID_MIN_SPEED, ASTEROID_MAX_SPEED)*cos(asteroid.rotation*DEG2RAD)*speedScale 
+	};
+
+	asteroid.position = position;
+	asteroid.status = status;
+	
+	switch (status) {
+		case 2:
+			asteroid.radius = (float)(rand_text.width * ASTEROID_BIG_SIZE) / 2;
+			break;
+
+		case 1:
+			asteroid.radius = (float)(rand_text.width * ASTEROID_MEDIUM_SIZE) / 2;
+			break;
+
+		case 0:
+			asteroid.radius = (float)(rand_text.width * ASTEROID_SMALL_SIZE) / 2;
+			break;
+	}
+	
+	asteroids.push_back(asteroid); // Add asteroid to list
+}
+
+void UpdateAsteroids(std::vector<Asteroid> &asteroids, float delta) {
+	TRACE_FUNCTION();
+
+	for (int i = 0; i < asteroids.size(); i++) {
+		// Movement
+		asteroids[i].position.x += asteroids[i].speed.x * delta;
+		asteroids[i].position.y -= asteroids[i].speed.y * delta;
+
+		// Check if asteroid is out of world bounds 
+		if (asteroids[i].position.x > worldWidth + asteroids[i].radius) asteroids[i].position.x = -(asteroids[i].radius);
+		else if (asteroids[i].position.x < -(asteroids[i].radius)) asteroids[i].position.x = worldWidth + asteroids[i].radius;
+		if (asteroids[i].position.y > (worldHeight + asteroids[i].radius)) asteroids[i].position.y = -(asteroids[i].radius);
+		else if (asteroids[i].position.y < -(asteroids[i].radius)) asteroids[i].position.y = worldHeight + asteroids[i].radius;
+
+		// Check if asteroid is colliding with player
+		if (CheckCollisionCircles(asteroids[i].position, asteroids[i].radius, player.position, playerHitRadius)) {
+			asteroids.erase(asteroids.begin() + i);
+			lives--;
+			audioMixer.play(SOUND_EXPLOSION);
+
+			// The next asteroid moved into slot i
+			i--;
+			continue;
+		}
+
+		// Check if asteroid is colliding with bullets
+		for (int j = 0; j < bullets.size(); j++) {
+			if (CheckCollisionCircles(asteroids[i].position, asteroids[i].radius, bullets[j].position, bullets[j].radius)) {
+				bullets.erase(bullets.begin() + j);
+				audioMixer.play(SOUND_EXPLOSION, 0.4f + 0.3f * asteroids[i].status);
+				
+				// The pieces are queued and spawned after this update, at most SPAWN_BUDGET per tick
+				if (asteroids[i].status == 2) {
+					waveDirector.queueSplit(1, asteroids[i].position, random_int(2, 3));
+				}
+				else if (asteroids[i].status == 1) {
+					waveDirector.queueSplit(0, asteroids[i].position, random_int(2, 3));
+				}
+				else if (asteroids[i].status == 0) {
+					score += 1;
+				}
+
+				// The asteroid is gone, stop testing it against the other bullets
+				asteroids.erase(asteroids.begin() + i);
+				i--;
+				break;
+			}
+		}
+	}
+}
+
+int random_int(int range_from, int range_to) {
+    std::random_device                  rand_dev;
+    std::mt19937                        generator(rand_dev());
+    std::uniform_int_distribution<int>    distr(range_from, range_to);
+    return distr(generator);
+}
+
+double random_dbl(double range_from, double range_to) {
+	std::random_device                  rand_dev;
+	std::mt19937                        generator(rand_dev());
+	std::uniform_real_distribution<double>    distr(range_from, range_to);
+	return distr(generator);
+}
+
+float random_flt(float range_from, float range_to) {
+	std::random_device                  rand_dev;
+	std::mt19937                        generator(rand_dev());
+	std::uniform_real_distribution<float>    distr(range_from, range_to);
+	return distr(generator);
+}
+
+static void SimulationLoop(int ticksPerSecond) {
+	TraceSetThreadName("simulation");
+
+	nanoseconds tick = duration_cast<nanoseconds>(duration<double>(1.0 / ticksPerSecond));
+	steady_clock::time_point lastTick = steady_clock::now();
+	steady_clock::time_point nextTick = lastTick;
+
+	while (simulationRunning.load(std::memory_order_acquire)) {
+		steady_clock::time_point start = steady_clock::now();
+		float delta = duration<float>(start - lastTick).count();
+		lastTick = start;
+
+		TickSimulation(simulationInputs.front(), delta);
+		PublishSnapshot(duration<float>(steady_clock::now() - start).count());
+
+		// Keep a fixed rate; after an overrun start the next tick right away instead of catching up
+		nextTick += tick;
+		if (nextTick < steady_clock::now()) nextTick = steady_clock::now();
+		std::this_thread::sleep_until(nextTick);
+	}
+}
+
+void StartSimulationThread(int ticksPerSecond) {
+	simulationRunning.store(true, std::memory_order_release);
+	simulationThread = std::thread(SimulationLoop, ticksPerSecond);
+}
+
+void StopSimulationThread() {
+	if (!simulationThread.joinable()) return;
+
+	simulationRunning.store(false, std::memory_order_release);
+	simulationThread.join();
+}
+
+void SetSimulationInput(const SimulationInput &input) {
+	simulationInputs.back() = input;
+	simulationInputs.publish();
+}
+
+void PublishSnapshot(float updateTime) {
+	TRACE_FUNCTION();
+
+	RenderSnapshot &snapshot = snapshots.back();
+
+	snapshot.player = player;
+	snapshot.playerFlying = playerFlying;
+	snapshot.playerRotationInput = playerRotationInput;
+
+	// assign() keeps the slot's capacity, so steady state publishing does not allocate
+	snapshot.bullets.assign(bullets.begin(), bullets.end());
+	snapshot.asteroids.assign(asteroids.begin(), asteroids.end());
+
+	snapshot.score = score;
+	snapshot.lives = lives;
+	snapshot.wave = waveDirector.wave;
+	snapshot.gameOver = gameOver;
+
+	snapshot.inputTime = inputTime;
+	snapshot.tickDelta = tickDelta;
+	snapshot.updateTime = updateTime;
+
+	snapshots.publish();
+}
+
+RenderSnapshot& ConsumeSnapshot() {
+	return snapshots.front();
+}
@@ -0,0 +1,155 @@
+#ifndef SIMULATION_INCLUDED
+
+#define SIMULATION_INCLUDED
+#include <vector>
+#include "raylib.h"
+#include "wave_director.hpp"
+
+//-------------------
+// Constant Variables
+//-------------------
+
+// === Player ===
+#define PLAYER_SIZE  0.2f
+#define PLAYER_SPEED 300.0f
+#define PLAYER_ROTATION_SPEED 250.0f
+#define PLAYER_ACCELERATION 0.5f
+#define PLAYER_MAX_ACCELERATION 2.5f
+#define DRAG 0.02f
+
+// === Bullet ===
+#define BULLET_SPEED 400.0f
+#define BULLET_SIZE 0.4f
+#define SHOOTING_DELAY 0.1f // 0.1 seconds
+
+// === Asteroid ===
+#define ASTEROID_BIG_SIZE 0.5f
+#define ASTEROID_MEDIUM_SIZE 0.3f
+#define ASTEROID_SMALL_SIZE 0.1f
+#define ASTEROID_MAX_SPEED 200.0f
+#define ASTEROID_MIN_SPEED 150.0f
+
+// === Spawning ===
+#define SPAWN_BUDGET 8				// most asteroids spawned per tick
+#define SPAWN_SAFE_RADIUS 350.0f	// wave asteroids never spawn this close to the player
+#define SPAWN_ATTEMPTS 8			// free spots tried per asteroid before retrying next tick
+
+// === World ===
+#define WORLD_CELL_SIZE 128.0f		// spatial index cell size
+
+//------
+// Types
+//------
+struct Player {
+    Vector2 position;
+    Vector2 speed;
+    float acceleration;
+    float rotation;
+};
+
+struct Bullet {
+	Vector2 position;
+	Vector2 speed;
+	float rotation;
+	float radius;
+};
+
+struct Asteroid {
+	Texture2D texture;
+	Vector2 position;
+	Vector2 speed;
+	float rotation;
+	float radius;
+	int status; // 2 = big, 1 = medium, 0 = small
+};
+
+// What the simulation reads from the main thread each tick
+struct SimulationInput {
+	// Held keys
+	bool rotateLeft;
+	bool rotateRight;
+	bool thrust;
+	bool brake;
+	bool shoot;
+
+	// Game state owned by the main thread
+	bool startScreen;
+	bool pause;
+	unsigned int restart;	// bumped by the main thread to start a new game
+
+	double time;	// GetTime() when the input was sampled
+};
+
+// Copy of the world handed from the simulation to the renderer
+struct RenderSnapshot {
+	Player player;
+	bool playerFlying;
+	float playerRotationInput;	// rotation direction applied by the last tick (-1, 0, 1)
+	std::vector<Bullet> bullets;
+	std::vector<Asteroid> asteroids;
+
+	int score;
+	int lives;
+	int wave;
+	bool gameOver;
+
+	double inputTime;	// sample time of the input the snapshot was simulated with
+	float tickDelta;	// delta of the tick, 0 when it did not move the ship
+	float updateTime;	// time spent in the tick that produced it (seconds)
+};
+
+//--------
+// Globals
+//--------
+
+// === World ===
+extern const int worldWidth;
+extern const int worldHeight;
+
+extern int score;
+extern int lives;
+extern bool gameOver;
+
+// === Player ===
+extern Player player;
+extern float playerHitRadius;	// radius used for asteroid collisions
+extern float shipHeight;		// distance from the ship center to its nose
+extern bool playerFlying;
+extern float playerRotationInput;
+
+// === Bullets ===
+extern float bulletRadius;
+extern std::vector<Bullet> bullets;
+
+// === Asteroids ===
+extern Texture2D asteroidTexture1;
+extern Texture2D asteroidTexture2;
+extern Texture2D asteroidTexture3;
+extern std::vector<Asteroid> asteroids;
+extern WaveDirector waveDirector;
+
+// === Function prototypes ===
+void ResetSimulation();													// Reset the world for a new game
+void TickSimulation(const SimulationInput &input, float delta);		// Advance the world by delta seconds
+
+void UpdatePlayer(const SimulationInput &input, float delta);			// Update player
+void Shoot(float delta);												// Shoot
+void UpdateBullets(std::vector<Bullet> &bullets, float delta);			// Update bullets
+void SpawnAsteroid(int status, Vector2 position, float speedScale = 1.0f);	// Spawn asteroid
+void UpdateAsteroids(std::vector<Asteroid> &asteroids, float delta);	// Update asteroids
+
+int random_int(int range_from, int range_to);					// Generate random int
+double random_dbl(double range_from, double range_to);			// Generate random double
+float random_flt(float range_from, float range_to);				// Generate random float
+
+// === Pipelining ===
+// The simulation can run on its own thread. It reads the latest SimulationInput
+// and publishes a RenderSnapshot after every tick; both go through lock-free
+// triple buffers, so neither thread ever waits for the other.
+void StartSimulationThread(int ticksPerSecond);		// Tick the world on a background thread
+void StopSimulationThread();						// Stop and join the simulation thread
+void SetSimulationInput(const SimulationInput &input);	// Hand input to the simulation (main thread)
+void PublishSnapshot(float updateTime);				// Copy the world into the next snapshot (simulation side)
+RenderSnapshot& ConsumeSnapshot();					// Newest published snapshot (main thread)
+
+#endif
@@ -0,0 +1,55 @@
+#include "spatial_grid.hpp"
+
+SpatialGrid::SpatialGrid(float width, float height, float cellSize) {
+	this->cellSize = cellSize;
+	this->columns = (int)(width / cellSize) + 1;
+	this->rows = (int)(height / cellSize) + 1;
+	this->cells.resize(columns * rows);
+}
+
+void SpatialGrid::clear() {
+	for (int i = 0; i < cells.size(); i++) {
+		cells[i].clear();
+	}
+	largestRadius = 0.0f;
+}
+
+void SpatialGrid::insert(int id, Vector2 position, float radius) {
+	cells[cellRow(position.y) * columns + cellColumn(position.x)].push_back(id);
+
+	if (radius > largestRadius) largestRadius = radius;
+}
+
+void SpatialGrid::query(Rectangle area, std::vector<int> &result) {
+	result.clear();
+
+	int minColumn = cellColumn(area.x - largestRadius);
+	int maxColumn = cellColumn(area.x + area.width + largestRadius);
+	int minRow = cellRow(area.y - largestRadius);
+	int maxRow = cellRow(area.y + area.height + largestRadius);
+
+	for (int row = minRow; row <= maxRow; row++) {
+		for (int column = minColumn; column <= maxColumn; column++) {
+			std::vector<int> &cell = cells[row * columns + column];
+			result.insert(result.end(), cell.begin(), cell.end());
+		}
+	}
+}
+
+int SpatialGrid::getCellCount(int column, int row) {
+	return cells[row * columns + column].size();
+}
+
+int SpatialGrid::cellColumn(float x) {
+	int column = (int)(x / cellSize);
+	if (column < 0) return 0;
+	if (column >= columns) return columns - 1;
+	return column;
+}
+
+int SpatialGrid::cellRow(float y) {
+	int row = (int)(y / cellSize);
+	if (row < 0) return 0;
+	if (row >= rows) return rows - 1;
+	return row;
+}
@@ -0,0 +1,38 @@
+#ifndef SPATIAL_GRID_INCLUDED
+
+#define SPATIAL_GRID_INCLUDED
+#include <vector>
+#include "raylib.h"
+
+// Uniform grid over the world, bucketing entity ids by the cell of their center.
+// Rebuilt every frame; queries return every id whose circle may overlap an area.
+class SpatialGrid {
+	public:
+
+		// Layout of the grid
+		float cellSize;		// width and height of a cell
+		int columns;		// number of cells on the x axis
+		int rows;			// number of cells on the y axis
+
+		// Constructors
+		SpatialGrid() = default;
+		SpatialGrid(float width, float height, float cellSize);
+
+		// Building
+		void clear();									// remove all ids, keeping the memory
+		void insert(int id, Vector2 position, float radius);	// add an id at position
+
+		// Queries
+		void query(Rectangle area, std::vector<int> &result);	// ids that may overlap area (result is overwritten)
+		int getCellCount(int column, int row);					// number of ids in a cell
+
+	private:
+
+		std::vector<std::vector<int>> cells;
+		float largestRadius = 0.0f;		// queries are grown by this so big entities are not missed
+
+		int cellColumn(float x);
+		int cellRow(float y);
+};
+
+#endif
@@ -0,0 +1,175 @@
+#include "trace.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <stdint.h>
+
+// Events per thread buffer (must be a power of two)
+#define TRACE_BUFFER_SIZE 16384
+// How often the writer thread drains the buffers
+#define TRACE_DRAIN_INTERVAL 5 // 5 milliseconds
+
+using namespace std::chrono;
+
+//------
+// Types
+//------
+struct TraceRecord {
+	const char* name;
+	int64_t start;		// nanoseconds since TraceStart
+	int64_t duration;	// nanoseconds
+};
+
+// Single producer (owning thread) / single consumer (writer thread) ring buffer
+struct TraceBuffer {
+	TraceRecord records[TRACE_BUFFER_SIZE];
+	std::atomic<uint32_t> head{ 0 };		// next slot to write, owned by the producer
+	std::atomic<uint32_t> tail{ 0 };		// next slot to read, owned by the consumer
+	std::atomic<uint64_t> dropped{ 0 };		// events lost because the buffer was full
+	std::atomic<const char*> threadName{ nullptr };
+	bool nameWritten = false;
+	int threadId;
+};
+
+//--------
+// Globals
+//--------
+std::atomic<bool> traceEnabled{ false };
+
+static std::mutex bufferMutex;							// guards buffers (only taken when a thread registers)
+static std::vector<std::unique_ptr<TraceBuffer>> buffers;
+static thread_local TraceBuffer* threadBuffer = nullptr;
+
+static FILE* traceFile = nullptr;
+static bool firstEvent = true;
+static steady_clock::time_point traceStartTime;
+static std::atomic<bool> writerRunning{ false };
+static std::thread writerThread;
+
+//-----------
+// Functions
+//-----------
+
+static TraceBuffer* GetThreadBuffer() {
+	if (threadBuffer == nullptr) {
+		std::lock_guard<std::mutex> lock(bufferMutex);
+		buffers.push_back(std::unique_ptr<TraceBuffer>(new TraceBuffer()));
+		threadBuffer = buffers.back().get();
+		threadBuffer->threadId = buffers.size();
+	}
+	return threadBuffer;
+}
+
+static void WriteSeparator() {
+	if (!firstEvent) fputs(",\n", traceFile);
+	firstEvent = false;
+}
+
+// Write everything currently in the buffers to the file (writer thread only)
+static void DrainBuffers() {
+	std::vector<TraceBuffer*> snapshot;
+	{
+		std::lock_guard<std::mutex> lock(bufferMutex);
+		for (int i = 0; i < buffers.size(); i++) snapshot.push_back(buffers[i].get());
+	}
+
+	for (int i = 0; i < snapshot.size(); i++) {
+		TraceBuffer* buffer = snapshot[i];
+
+		const char* threadName = buffer->threadName.load(std::memory_order_acquire);
+		if (threadName != nullptr && !buffer->nameWritten) {
+			WriteSeparator();
+			fprintf(traceFile, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", buffer->threadId, threadName);
+			buffer->nameWritten = true;
+		}
+
+		uint32_t head = buffer->head.load(std::memory_order_acquire);
+		uint32_t tail = buffer->tail.load(std::memory_order_relaxed);
+
+		for (; tail != head; tail++) {
+			TraceRecord &record = buffer->records[tail & (TRACE_BUFFER_SIZE - 1)];
+			WriteSeparator();
+			fprintf(traceFile, "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}", record.name, record.start / 1000.0, record.duration / 1000.0, buffer->threadId);
+		}
+
+		buffer->tail.store(tail, std::memory_order_release);
+	}
+}
+
+static void WriterLoop() {
+	while (writerRunning.load(std::memory_order_acquire)) {
+		DrainBuffers();
+		std::this_thread::sleep_for(milliseconds(TRACE_DRAIN_INTERVAL));
+	}
+}
+
+bool TraceStart(const char* path) {
+	if (traceFile != nullptr) return false;
+
+	traceFile = fopen(path, "w");
+	if (traceFile == nullptr) return false;
+
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", traceFile);
+	firstEvent = true;
+	traceStartTime = steady_clock::now();
+
+	writerRunning.store(true, std::memory_order_release);
+	writerThread = std::thread(WriterLoop);
+	traceEnabled.store(true, std::memory_order_release);
+	return true;
+}
+
+void TraceStop() {
+	if (traceFile == nullptr) return;
+
+	traceEnabled.store(false, std::memory_order_release);
+	writerRunning.store(false, std::memory_order_release);
+	writerThread.join();
+	DrainBuffers();
+
+	// Report dropped events so a truncated trace is not mistaken for a quiet one
+	uint64_t dropped = 0;
+	{
+		std::lock_guard<std::mutex> lock(bufferMutex);
+		for (int i = 0; i < buffers.size(); i++) dropped += buffers[i]->dropped.load(std::memory_order_relaxed);
+	}
+
+	fprintf(traceFile, "\n],\"otherData\":{\"droppedEvents\":\"%llu\"}}\n", (unsigned long long)dropped);
+	fclose(traceFile);
+	traceFile = nullptr;
+}
+
+int64_t TraceTimestamp() {
+	return duration_cast<nanoseconds>(steady_clock::now() - traceStartTime).count();
+}
+
+void TraceEvent(const char* name, int64_t start) {
+	// Stopped while the scope was open: drop the whole event
+	if (!traceEnabled.load(std::memory_order_relaxed)) return;
+
+	TraceBuffer* buffer = GetThreadBuffer();
+	uint32_t head = buffer->head.load(std::memory_order_relaxed);
+
+	if (head - buffer->tail.load(std::memory_order_acquire) >= TRACE_BUFFER_SIZE) {
+		buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	TraceRecord &record = buffer->records[head & (TRACE_BUFFER_SIZE - 1)];
+	record.name = name;
+	record.start = start;
+	record.duration = TraceTimestamp() - start;
+
+	buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void TraceSetThreadName(const char* name) {
+	// Buffers are only allocated for threads that trace
+	if (!traceEnabled.load(std::memory_order_relaxed)) return;
+
+	GetThreadBuffer()->threadName.store(name, std::memory_order_release);
+}
@@ -0,0 +1,54 @@
+#ifndef TRACE_INCLUDED
+
+#define TRACE_INCLUDED
+#include <atomic>
+#include <stdint.h>
+
+// Chrome trace event recorder.
+//
+// Every thread writes complete events (start + duration) into its own lock-free
+// ring buffer and a background thread drains them into a JSON file that
+// chrome://tracing and Perfetto (ui.perfetto.dev) can open. When tracing is not
+// started a scope costs one relaxed atomic load and no buffer is allocated;
+// building without ASTROX_TRACE removes the macros.
+
+extern std::atomic<bool> traceEnabled;
+
+bool TraceStart(const char* path);						// Start writing events to path
+void TraceStop();										// Flush remaining events and close the file
+int64_t TraceTimestamp();								// Nanoseconds since TraceStart
+void TraceEvent(const char* name, int64_t start);		// Record an event that began at start and ends now
+void TraceSetThreadName(const char* name);				// Name the calling thread in the trace (only while tracing)
+
+// Records one event covering its lifetime when it is destroyed
+class TraceScope {
+	public:
+
+		TraceScope(const char* name) {
+			if (traceEnabled.load(std::memory_order_relaxed)) {
+				this->name = name;
+				start = TraceTimestamp();
+			}
+		}
+
+		~TraceScope() {
+			if (name != nullptr) TraceEvent(name, start);
+		}
+
+	private:
+
+		const char* name = nullptr;	// must be a string literal (or otherwise outlive the trace)
+		int64_t start = 0;
+};
+
+#ifdef ASTROX_TRACE
+	#define TRACE_CONCAT_INNER(a, b) a##b
+	#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+	#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+	#define TRACE_FUNCTION() TRACE_SCOPE(__func__)
+#else
+	#define TRACE_SCOPE(name)
+	#define TRACE_FUNCTION()
+#endif
+
+#endif
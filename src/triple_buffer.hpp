@@ -0,0 +1,41 @@
+#ifndef TRIPLE_BUFFER_INCLUDED
+
+#define TRIPLE_BUFFER_INCLUDED
+#include <atomic>
+
+// Lock-free single writer / single reader triple buffer.
+// The writer fills back() and calls publish(); the reader calls front() and always
+// gets the newest published value. Neither side ever waits for the other.
+template <typename T>
+class TripleBuffer {
+	public:
+
+		// Writer side
+		T& back() {
+			return buffers[backIndex];
+		}
+
+		void publish() {
+			backIndex = middle.exchange(backIndex | DIRTY, std::memory_order_acq_rel) & INDEX_MASK;
+		}
+
+		// Reader side
+		T& front() {
+			if (middle.load(std::memory_order_relaxed) & DIRTY) {
+				frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+			}
+			return buffers[frontIndex];
+		}
+
+	private:
+
+		static const int INDEX_MASK = 3;
+		static const int DIRTY = 4;		// set when middle holds a value the reader has not seen
+
+		T buffers[3];
+		std::atomic<int> middle{ 1 };
+		int backIndex = 0;
+		int frontIndex = 2;
+};
+
+#endif
@@ -0,0 +1,127 @@
+#include "wave_director.hpp"
+
+#include <iterator>
+#include <stdio.h>
+
+// Growth per wave once the table runs out
+#define WAVE_EXTRA_ASTEROIDS 2
+#define WAVE_EXTRA_SPEED 0.1f
+#define WAVE_MAX_SPEED_SCALE 2.0f
+
+// Used when no wave table file is found
+static const WaveDefinition defaultWaves[] = {
+	{ 4, 1.0f, 0.25f },
+	{ 5, 1.05f, 0.2f },
+	{ 6, 1.1f, 0.2f },
+	{ 8, 1.2f, 0.15f },
+	{ 10, 1.3f, 0.15f },
+};
+
+WaveDirector::WaveDirector(std::vector<WaveDefinition> waves, int spawnBudget) {
+	this->waves = waves;
+	this->spawnBudget = spawnBudget;
+	reset();
+}
+
+void WaveDirector::reset() {
+	wave = 0;
+	waveTimer = 0.0f;
+	splitQueue.clear();
+	waveQueue.clear();
+}
+
+void WaveDirector::startWave() {
+	wave++;
+	WaveDefinition definition = getWave(wave);
+
+	for (int i = 0; i < definition.asteroids; i++) {
+		waveQueue.push_back(SpawnRequest{ 2, Vector2{ 0, 0 }, definition.speedScale, true });
+	}
+	waveTimer = 0.0f;
+}
+
+void WaveDirector::queueSplit(int status, Vector2 position, int count) {
+	float speedScale = wave > 0 ? getWave(wave).speedScale : 1.0f;
+
+	for (int i = 0; i < count; i++) {
+		splitQueue.push_back(SpawnRequest{ status, position, speedScale, false });
+	}
+}
+
+void WaveDirector::requeue(SpawnRequest request) {
+	if (request.placeFreely) {
+		// Retry on the next tick, not after another spawn interval
+		waveQueue.push_front(request);
+		waveTimer = 0.0f;
+	}
+	else splitQueue.push_front(request);
+}
+
+void WaveDirector::takeDue(float delta, std::vector<SpawnRequest> &due) {
+	due.clear();
+
+	// Splits first: they continue an explosion the player is looking at
+	while (due.size() < spawnBudget && !splitQueue.empty()) {
+		due.push_back(splitQueue.front());
+		splitQueue.pop_front();
+	}
+
+	// Wave asteroids trickle in at the wave's interval
+	waveTimer -= delta;
+	if (due.size() < spawnBudget && !waveQueue.empty() && waveTimer <= 0.0f) {
+		due.push_back(waveQueue.front());
+		waveQueue.pop_front();
+		waveTimer = getWave(wave).spawnInterval;
+	}
+}
+
+bool WaveDirector::isIdle() {
+	return splitQueue.empty() && waveQueue.empty();
+}
+
+WaveDefinition WaveDirector::getWave(int wave) {
+	const WaveDefinition* table = waves.empty() ? defaultWaves : waves.data();
+	int tableSize = waves.empty() ? std::size(defaultWaves) : waves.size();
+
+	if (wave < 1) wave = 1;
+	if (wave <= tableSize) return table[wave - 1];
+
+	// Past the table: keep ramping from its last row
+	WaveDefinition definition = table[tableSize - 1];
+	int extra = wave - tableSize;
+	definition.asteroids += extra * WAVE_EXTRA_ASTEROIDS;
+	definition.speedScale += extra * WAVE_EXTRA_SPEED;
+	if (definition.speedScale > WAVE_MAX_SPEED_SCALE) definition.speedScale = WAVE_MAX_SPEED_SCALE;
+	return definition;
+}
+
+std::vector<WaveDefinition> LoadWaveTable(const char* path) {
+	std::vector<WaveDefinition> waves;
+
+	// One wave per line: <asteroids> <speed scale> <spawn interval>, '#' starts a comment
+	FILE* file = fopen(path, "r");
+	if (file != nullptr) {
+		char line[256];
+		int lineNumber = 0;
+		while (fgets(line, sizeof(line), file) != nullptr) {
+			WaveDefinition definition;
+			lineNumber++;
+			if (line[0] == '#') continue;
+			if (sscanf(line, "%d %f %f", &definition.asteroids, &definition.speedScale, &definition.spawnInterval) != 3) continue;
+
+			// An empty wave would end as soon as it starts and skip a wave every tick
+			if (definition.asteroids < 1 || definition.speedScale <= 0.0f || definition.spawnInterval < 0.0f) {
+				TraceLog(LOG_WARNING, "WAVES: %s:%d needs asteroids >= 1, speed scale > 0 and interval >= 0, row skipped", path, lineNumber);
+				continue;
+			}
+			waves.push_back(definition);
+		}
+		fclose(file);
+	}
+
+	if (waves.empty()) {
+		TraceLog(LOG_WARNING, "WAVES: Could not read %s, using the built-in wave table", path);
+		waves.assign(std::begin(defaultWaves), std::end(defaultWaves));
+	}
+	return waves;
+}
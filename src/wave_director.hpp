@@ -0,0 +1,58 @@
+#ifndef WAVE_DIRECTOR_INCLUDED
+
+#define WAVE_DIRECTOR_INCLUDED
+#include <deque>
+#include <vector>
+#include "raylib.h"
+
+// One row of the wave table
+struct WaveDefinition {
+	int asteroids;			// big asteroids in the wave
+	float speedScale;		// multiplier on asteroid speed
+	float spawnInterval;	// seconds between two asteroids of the wave
+};
+
+// An asteroid waiting to be spawned
+struct SpawnRequest {
+	int status;				// 2 = big, 1 = medium, 0 = small
+	Vector2 position;		// where to spawn (split children only)
+	float speedScale;
+	bool placeFreely;		// wave asteroids: the simulation picks a free spot
+};
+
+// Queues asteroid spawns and hands them out a few per tick, so neither a new
+// wave nor a burst of splits lands in a single frame.
+class WaveDirector {
+	public:
+
+		std::vector<WaveDefinition> waves;	// wave table, extrapolated past its end
+		int wave = 0;						// current wave (1 based, 0 before the first one)
+		int spawnBudget;					// most spawns handed out per tick
+
+		// Constructors
+		WaveDirector() = default;
+		WaveDirector(std::vector<WaveDefinition> waves, int spawnBudget);
+
+		// Queueing
+		void reset();													// back to before the first wave
+		void startWave();												// queue the next wave of the table
+		void queueSplit(int status, Vector2 position, int count);		// queue the pieces of a destroyed asteroid
+		void requeue(SpawnRequest request);								// retry a request next tick
+
+		// Spawning
+		void takeDue(float delta, std::vector<SpawnRequest> &due);		// requests to spawn this tick (due is overwritten)
+
+		// State getters
+		bool isIdle();							// nothing left to spawn
+		WaveDefinition getWave(int wave);		// definition of a wave (1 based)
+
+	private:
+
+		std::deque<SpawnRequest> splitQueue;	// spawned as soon as the budget allows
+		std::deque<SpawnRequest> waveQueue;		// spawned one per spawnInterval
+		float waveTimer = 0.0f;					// time until the next wave asteroid
+};
+
+std::vector<WaveDefinition> LoadWaveTable(const char* path);	// Read a wave table, falls back to the built-in one
+
+#endif